@@ -0,0 +1,20 @@
+#!/bin/sh
+# 16 scripts fib(18) num --batch: um isolate por script, uma thread por
+# núcleo. A linha "-- batch" traz o número de threads e o tempo total.
+#   bench/isolates.sh [caminho/do/monny]
+set -e
+monny=${1:-build/linux/x86_64/release/monny}
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+for i in $(seq 1 16); do
+    cat > "$dir/fib$i.mn" <<'SCRIPT'
+func fib(n) {
+    if (n < 2) { return n; }
+    return fib(n - 1) + fib(n - 2);
+}
+print(fib(18), "\n");
+SCRIPT
+done
+
+"$monny" --batch "$dir" | grep -- '-- batch'
@@ -4,11 +4,41 @@
 #include <filesystem>
 #include <vector>
 #include <fstream>
+#include <memory>
+#include <interpreter/Program.hpp>
+#include <interpreter/Heap.hpp>
+
+class Isolate;
 
 class Monny {
 private:
-    static void run(const std::string&);
+    // Status de saída (sysexits): erro de sintaxe ou de runtime
+    static int run(const std::string&);
+    static int readScript(const std::string&, std::string&, std::ostream&);
 public:
+    struct Options {
+        // 0 = pilha nativa; > 0 = pilha no heap com esse limite de chamadas
+        size_t maxDepth = 0;
+        // Limiares do coletor de ciclos (--gc-young, --gc-growth)
+        Heap::Limits heap;
+        // --gc-stats: resumo das coletas no stderr ao terminar
+        bool gcStats = false;
+        // --alloc-stats: alocações por classe do Pool no stderr ao terminar
+        bool allocStats = false;
+    };
+
+    static Options options;
+
+    // Tokeniza e parseia uma vez; lança std::runtime_error em erro de sintaxe
+    static std::shared_ptr<const Program> compile(const std::string&);
+
+    static void loadExtension(const std::string&);
     static void runScriptFile(const std::string&);
+    // Executa no isolate e retorna o status de saída (sysexits)
+    static int runScriptFile(const std::string&, Isolate&);
+    // Roda vários scripts em paralelo; retorna o status de saída do processo
+    static int runBatch(const std::string&);
+    // Atende pedidos num Unix domain socket até o processo ser encerrado
+    static int serve(const std::string&);
     static void runREPL();
-};
\ No newline at end of file
+};
@@ -1,51 +1,385 @@
 // ArrayObject.hpp (crie este arquivo)
 #pragma once
+#include <interpreter/Heap.hpp>
+#include <utils/Pool.hpp>
 #include <vector>
 #include <any>
+#include <memory>
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
 
-class ArrayObject
+// Arrays só de números guardam os valores num buffer contíguo de double
+// (8 bytes por elemento, sem std::any). O primeiro valor não numérico
+// escrito rebaixa o array para o armazenamento genérico, de vez.
+//
+// slice() e arr[a:b] criam views: o array novo aponta para um trecho do
+// mesmo armazenamento, sem copiar elementos. Quem escrever primeiro (a
+// view ou o array de origem) copia antes o seu trecho, então para o
+// script uma view se comporta como uma cópia.
+class ArrayObject : public Collectable
 {
+private:
+    struct Storage
+    {
+        std::vector<std::any> elements;
+        std::vector<double> numbers;
+        bool numeric = true;
+        // Arrays apontando para este armazenamento
+        std::atomic<uint32_t> owners{1};
+
+        size_t size() const { return numeric ? numbers.size() : elements.size(); }
+
+        static void *operator new(size_t size) { return Pool::allocate(size); }
+        static void operator delete(void *block, size_t size) { Pool::deallocate(block, size); }
+    };
+
+    Storage *storage;
+    // Trecho do armazenamento que é deste array
+    size_t start = 0;
+    size_t length = 0;
+    // float64_array(): nunca rebaixa; escrever outra coisa é erro
+    bool fixed = false;
+    mutable std::mutex mutex;
+
+    // Só trava depois que o programa criou alguma task
+    std::unique_lock<std::mutex> guard() const
+    {
+        return concurrent ? std::unique_lock<std::mutex>(mutex) : std::unique_lock<std::mutex>();
+    }
+
+    // View de [from, from + count) de parent; parent já travado
+    ArrayObject(const ArrayObject &parent, size_t from, size_t count)
+        : storage(parent.storage), start(parent.start + from), length(count), fixed(parent.fixed)
+    {
+        storage->owners.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() noexcept
+    {
+        if (storage->owners.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete storage;
+        }
+    }
+
+    void checkIndex(long index) const
+    {
+        if (index < 0 || static_cast<size_t>(index) >= length)
+        {
+            throw std::runtime_error("Array index out of bounds");
+        }
+    }
+
+    // Antes de qualquer escrita: deixa o armazenamento só com o trecho
+    // deste array e sem mais ninguém apontando para ele
+    void own()
+    {
+        if (storage->owners.load(std::memory_order_acquire) == 1)
+        {
+            if (start != 0 || length != storage->size())
+            {
+                // A origem já foi coletada: corta o resto no próprio buffer
+                if (storage->numeric)
+                {
+                    storage->numbers.resize(start + length);
+                    storage->numbers.erase(storage->numbers.begin(), storage->numbers.begin() + start);
+                }
+                else
+                {
+                    storage->elements.resize(start + length);
+                    storage->elements.erase(storage->elements.begin(), storage->elements.begin() + start);
+                }
+                start = 0;
+            }
+            return;
+        }
+
+        Storage *copy = new Storage;
+        copy->numeric = storage->numeric;
+        if (storage->numeric)
+        {
+            copy->numbers.assign(numbersBegin(), numbersBegin() + length);
+        }
+        else
+        {
+            copy->elements.assign(elementsBegin(), elementsBegin() + length);
+        }
+        release();
+        storage = copy;
+        start = 0;
+    }
+
+    // Passa para o armazenamento genérico antes de guardar um não número.
+    // Só depois de own().
+    void demoteFor(const std::any &value)
+    {
+        if (!storage->numeric || value.type() == typeid(double))
+        {
+            return;
+        }
+        if (fixed)
+        {
+            throw std::runtime_error("float64_array only stores numbers");
+        }
+        storage->elements.reserve(storage->numbers.size() + 1);
+        for (double number : storage->numbers)
+        {
+            storage->elements.emplace_back(number);
+        }
+        storage->numbers.clear();
+        storage->numbers.shrink_to_fit();
+        storage->numeric = false;
+    }
+
+    const double *numbersBegin() const { return storage->numbers.data() + start; }
+    const std::any *elementsBegin() const { return storage->elements.data() + start; }
+
 public:
-    std::vector<std::any> elements;
+    // Ligada no primeiro spawn: a partir daí qualquer array pode estar
+    // sendo usado por mais de uma thread
+    inline static std::atomic<bool> concurrent{false};
+
+    ArrayObject(std::vector<std::any> values) : storage(new Storage), length(values.size())
+    {
+        for (const auto &value : values)
+        {
+            if (value.type() != typeid(double))
+            {
+                storage->numeric = false;
+                storage->elements = std::move(values);
+                return;
+            }
+        }
+        storage->numbers.reserve(values.size());
+        for (const auto &value : values)
+        {
+            storage->numbers.push_back(*std::any_cast<double>(&value));
+        }
+    }
+
+    // Array numérico; fixed = o de float64_array()
+    explicit ArrayObject(std::vector<double> values, bool fixed = false)
+        : storage(new Storage), length(values.size()), fixed(fixed)
+    {
+        storage->numbers = std::move(values);
+    }
+
+    ArrayObject(const ArrayObject &) = delete;
+    ArrayObject &operator=(const ArrayObject &) = delete;
 
-    ArrayObject(std::vector<std::any> elements) : elements(elements) {}
+    ~ArrayObject()
+    {
+        untrack();
+        release();
+    }
+
+    size_t size() const
+    {
+        auto lock = guard();
+        return length;
+    }
 
-    std::string toString() const
+    // View dos elementos [from, to)
+    std::shared_ptr<ArrayObject> slice(long from, long to) const
     {
-        std::string result = "[";
-        for (size_t i = 0; i < elements.size(); i++)
+        auto lock = guard();
+        if (from < 0 || to < from || static_cast<size_t>(to) > length)
         {
-            if (i > 0)
-                result += ", ";
+            throw std::runtime_error("Slice bounds out of range");
+        }
+        return std::shared_ptr<ArrayObject>(new ArrayObject(*this, from, to - from));
+    }
 
-            // Converter cada elemento para string
-            if (elements[i].type() == typeid(std::string))
+    // Cópia dos elementos, para percorrer sem segurar o lock
+    std::vector<std::any> snapshot() const
+    {
+        auto lock = guard();
+        if (!storage->numeric)
+        {
+            return std::vector<std::any>(elementsBegin(), elementsBegin() + length);
+        }
+        return std::vector<std::any>(numbersBegin(), numbersBegin() + length);
+    }
+
+    std::any get(long index) const
+    {
+        auto lock = guard();
+        checkIndex(index);
+        if (storage->numeric)
+        {
+            return numbersBegin()[index];
+        }
+        return elementsBegin()[index];
+    }
+
+    void set(long index, std::any value)
+    {
+        auto lock = guard();
+        checkIndex(index);
+        own();
+        demoteFor(value);
+        if (storage->numeric)
+        {
+            storage->numbers[index] = *std::any_cast<double>(&value);
+            return;
+        }
+        storage->elements[index] = std::move(value);
+    }
+
+    void push(std::any value)
+    {
+        auto lock = guard();
+        own();
+        demoteFor(value);
+        if (storage->numeric)
+        {
+            storage->numbers.push_back(*std::any_cast<double>(&value));
+        }
+        else
+        {
+            storage->elements.push_back(std::move(value));
+        }
+        length++;
+    }
+
+    std::any pop()
+    {
+        auto lock = guard();
+        if (length == 0)
+        {
+            throw std::runtime_error("Cannot pop from empty array");
+        }
+        own();
+        length--;
+        if (storage->numeric)
+        {
+            double last = storage->numbers.back();
+            storage->numbers.pop_back();
+            return last;
+        }
+        std::any last = std::move(storage->elements.back());
+        storage->elements.pop_back();
+        return last;
+    }
+
+    // Números para os kernels de array. Sem tasks no ar, data aponta direto
+    // para o buffer (válido até a próxima escrita no array); com tasks, ou
+    // com armazenamento genérico, os valores são copiados em 'copy'.
+    // false se algum elemento não é número.
+    bool numbersView(std::vector<double> &copy, const double *&data, size_t &count) const
+    {
+        auto lock = guard();
+        if (storage->numeric && !concurrent)
+        {
+            data = numbersBegin();
+            count = length;
+            return true;
+        }
+        if (storage->numeric)
+        {
+            copy.assign(numbersBegin(), numbersBegin() + length);
+        }
+        else
+        {
+            copy.clear();
+            copy.reserve(length);
+            for (size_t i = 0; i < length; i++)
             {
-                result += "\"" + std::any_cast<std::string>(elements[i]) + "\"";
+                auto number = std::any_cast<double>(&elementsBegin()[i]);
+                if (number == nullptr)
+                {
+                    return false;
+                }
+                copy.push_back(*number);
             }
-            else if (elements[i].type() == typeid(bool))
+        }
+        data = copy.data();
+        count = copy.size();
+        return true;
+    }
+
+    // Percorre os elementos sem copiar. Com tasks no ar percorre uma cópia,
+    // para não segurar este lock enquanto visit trava outros arrays.
+    template <typename Visitor>
+    void forEach(Visitor &&visit) const
+    {
+        if (!concurrent)
+        {
+            if (storage->numeric)
             {
-                result += std::any_cast<bool>(elements[i]) ? "true" : "false";
+                for (size_t i = 0; i < length; i++)
+                {
+                    visit(std::any(numbersBegin()[i]));
+                }
+                return;
             }
-            else if (elements[i].type() == typeid(double))
+            for (size_t i = 0; i < length; i++)
             {
-                std::string num = std::to_string(std::any_cast<double>(elements[i]));
-                // Remover zeros desnecessários
-                num.erase(num.find_last_not_of('0') + 1, std::string::npos);
-                num.erase(num.find_last_not_of('.') + 1, std::string::npos);
-                result += num;
+                visit(elementsBegin()[i]);
             }
-            else if (elements[i].type() == typeid(nullptr))
+            return;
+        }
+        for (const auto &element : snapshot())
+        {
+            visit(element);
+        }
+    }
+
+    // Coletor de ciclos. O armazenamento inteiro conta, inclusive o que
+    // está fora do trecho: continua segurado até o próximo own().
+    void references(std::vector<Collectable *> &out) const override
+    {
+        for (const auto &element : storage->elements)
+        {
+            if (Collectable *object = Collectable::of(element))
             {
-                result += "nil";
+                out.push_back(object);
             }
-            else
+        }
+    }
+
+    const void *sharedReferences(size_t &sharers) const override
+    {
+        sharers = storage->owners.load(std::memory_order_acquire);
+        return sharers == 1 ? nullptr : storage;
+    }
+
+    void clearReferences(std::vector<std::any> &dead) override
+    {
+        if (storage->owners.load(std::memory_order_acquire) == 1)
+        {
+            for (auto &element : storage->elements)
             {
-                result += "?";
+                dead.push_back(std::move(element));
             }
+            storage->elements.clear();
+        }
+        else
+        {
+            // Views vivas continuam com os elementos
+            release();
+            storage = new Storage;
+        }
+        start = 0;
+        length = 0;
+    }
+
+    // Percorre direto o buffer de double, sob o lock (números não travam
+    // nada). false, sem visitar, se o array não é numérico.
+    template <typename Visitor>
+    bool forEachNumber(Visitor &&visit) const
+    {
+        auto lock = guard();
+        if (!storage->numeric)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < length; i++)
+        {
+            visit(numbersBegin()[i]);
         }
-        result += "]";
-        return result;
+        return true;
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <any>
+#include <cstdint>
+#include <span>
+#include <string>
+
+class Interpreter;
+
+// Função nativa: recebe os argumentos já avaliados
+using NativeFunction = std::any (*)(Interpreter &, std::span<const std::any>);
+
+struct Builtin
+{
+    std::string name;
+    // maxArity de um builtin sem limite de argumentos
+    static constexpr size_t unlimited = SIZE_MAX;
+
+    // Aceita de arity a maxArity argumentos
+    size_t arity;
+    size_t maxArity;
+    NativeFunction function;
+};
+
+// Registro de builtins. O parser resolve o nome da chamada para um índice
+// deste registro, então o interpretador não compara strings a cada chamada.
+// Registrar só é seguro antes de começar a interpretar.
+class Builtins
+{
+public:
+    // Registra (ou substitui) um builtin e retorna seu índice
+    static int add(const std::string &name, size_t arity, NativeFunction function);
+    static int add(const std::string &name, size_t minArity, size_t maxArity, NativeFunction function);
+    // Carrega um shared object e chama seu monny_register()
+    static void load(const std::string &path);
+
+    // Retorna -1 se o nome não for um builtin
+    static int lookup(const std::string &name);
+    static const Builtin &get(int id);
+};
+
+// Ponto de entrada de uma extensão carregada com --load:
+//
+//   MONNY_EXTENSION
+//   {
+//       Builtins::add("double_it", 1, doubleIt);
+//   }
+#define MONNY_EXTENSION extern "C" void monny_register()
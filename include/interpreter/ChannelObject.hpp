@@ -0,0 +1,53 @@
+#pragma once
+#include <any>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+// Canal com capacidade fixa entre tasks: fila circular MPMC sem lock
+// (cada célula tem um número de sequência que diz se está livre ou cheia).
+// Os valores são std::any: arrays e funções passam por ponteiro, sem cópia
+// profunda. send/recv bloqueiam quando o canal está cheio/vazio.
+class ChannelObject
+{
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        std::any value;
+    };
+
+    size_t capacity;
+    // Pelo menos 2: com uma célula só, 'livre na próxima volta' e 'cheia'
+    // teriam o mesmo número de sequência
+    size_t cellCount;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> sendPosition{0};
+    alignas(64) std::atomic<size_t> recvPosition{0};
+    std::atomic<bool> closed{false};
+
+    // Só para dormir depois de esperar um pouco; o caminho rápido não trava
+    std::mutex sleepMutex;
+    std::condition_variable changed;
+    std::atomic<int> sleepers{0};
+
+    void pause(unsigned &attempt);
+    void wakeSleepers();
+
+public:
+    // As células são alocadas de uma vez: capacidades maiores são erro
+    static constexpr size_t maxCapacity = 1 << 20;
+
+    explicit ChannelObject(size_t capacity);
+
+    // Não bloqueiam: false se o canal está cheio/vazio
+    bool trySend(std::any &value);
+    bool tryRecv(std::any &value);
+
+    // send em canal fechado é erro; recv em canal fechado e vazio devolve nil
+    void send(std::any value);
+    std::any recv();
+    void close();
+};
@@ -6,49 +6,251 @@
 #include <memory>
 #include <stdexcept>
 #include <vector>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <interpreter/String.hpp>
+#include <interpreter/Heap.hpp>
+#include <utils/Pool.hpp>
 
-class Environment : public std::enable_shared_from_this<Environment>
+class FunctionObject;
+class Shape;
+
+// Compartilhado por todos os environments de um interpretador. A época muda
+// sempre que um binding de função (ou de struct, que também se chama) é
+// criado, sombreado ou destruído; os
+// caches de chamada guardam a época em que foram preenchidos.
+struct FunctionBindings
+{
+    std::atomic<uint64_t> epoch{0};
+    std::unordered_set<std::string> names;
+
+    // Depois de um spawn, tasks de outras threads também mexem em 'names'
+    std::atomic<bool> shared{false};
+    std::mutex mutex;
+
+    bool contains(const std::string &name)
+    {
+        std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+        if (shared)
+            lock.lock();
+        return !names.empty() && names.count(name);
+    }
+
+    void insert(const std::string &name)
+    {
+        std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+        if (shared)
+            lock.lock();
+        names.insert(name);
+    }
+};
+
+class Environment : public Collectable
 {
 private:
-    std::vector<std::unordered_map<std::string, std::any>> scopes;
+    // Nós e buckets pelo Pool: cada chamada de função cria um escopo
+    using Scope = std::unordered_map<std::string, std::any, std::hash<std::string>, std::equal_to<std::string>,
+                                     PoolAllocator<std::pair<const std::string, std::any>>>;
+
+    std::vector<Scope, PoolAllocator<Scope>> scopes;
+    std::vector<bool> scopeHasFunction;
     std::unordered_set<std::string> constants;
     std::shared_ptr<Environment> parent;
+    std::shared_ptr<FunctionBindings> functions;
+
+    // Um environment visível a tasks (spawn) passa a ser travado: leituras
+    // compartilham o lock, escritas e mudanças de escopo são exclusivas.
+    // Environments nunca compartilhados não pagam nada além do teste da flag.
+    std::atomic<bool> shared{false};
+    mutable std::shared_mutex mutex;
+
+    // Geração em que foi criado; ver WriteBarrier
+    static inline std::atomic<uint64_t> generation{0};
+    static inline thread_local uint64_t writeBarrier = 0;
+    uint64_t born = generation.load(std::memory_order_relaxed);
+
+    void checkWritable(const std::string &name) const
+    {
+        if (born < writeBarrier)
+        {
+            throw std::runtime_error("Cannot assign to shared variable '" + name +
+                                     "' inside parallel for (declare it in the body or add it to reduce).");
+        }
+    }
+
+    std::shared_lock<std::shared_mutex> readLock() const
+    {
+        return shared ? std::shared_lock<std::shared_mutex>(mutex) : std::shared_lock<std::shared_mutex>();
+    }
+
+    std::unique_lock<std::shared_mutex> writeLock()
+    {
+        return shared ? std::unique_lock<std::shared_mutex>(mutex) : std::unique_lock<std::shared_mutex>();
+    }
+
+    static bool isFunction(const std::any &value)
+    {
+        return value.type() == typeid(std::shared_ptr<FunctionObject>) ||
+               value.type() == typeid(std::shared_ptr<const Shape>);
+    }
+
+    // Chamado quando um binding que é (ou sombreia) uma função muda
+    void touchFunction(const std::string &name, bool function, size_t scope)
+    {
+        functions->epoch++;
+        if (function)
+        {
+            functions->insert(name);
+            scopeHasFunction[scope] = true;
+        }
+    }
+
+protected:
+    // Coletor de ciclos: os valores de todos os escopos e o parent
+    void references(std::vector<Collectable *> &out) const override
+    {
+        for (const auto &scope : scopes)
+        {
+            for (const auto &[name, value] : scope)
+            {
+                if (Collectable *object = Collectable::of(value))
+                {
+                    out.push_back(object);
+                }
+            }
+        }
+        if (parent != nullptr)
+        {
+            out.push_back(parent.get());
+        }
+    }
+
+    void clearReferences(std::vector<std::any> &dead) override
+    {
+        for (auto &scope : scopes)
+        {
+            for (auto &[name, value] : scope)
+            {
+                dead.push_back(std::move(value));
+            }
+        }
+        dead.push_back(std::move(parent));
+    }
 
 public:
-    Environment() : parent(nullptr)
+    // Enquanto vive, a thread atual não pode reatribuir variáveis de
+    // environments criados antes de 'barrier' (um pedaço de parallel for
+    // só escreve no que ele mesmo criou, inclusive via funções chamadas).
+    // Cada job do pool instala a barreira de quem o criou: uma thread que
+    // roda outro job enquanto espera num join não empresta a sua.
+    class WriteBarrier
+    {
+    public:
+        explicit WriteBarrier(uint64_t barrier) : previous(writeBarrier)
+        {
+            writeBarrier = barrier;
+        }
+
+        ~WriteBarrier()
+        {
+            writeBarrier = previous;
+        }
+
+        // Os environments criados a partir daqui ficam do lado de dentro
+        static uint64_t open()
+        {
+            return ++generation;
+        }
+
+        // A barreira da thread atual, para passar aos jobs que ela cria
+        static uint64_t current()
+        {
+            return writeBarrier;
+        }
+
+    private:
+        uint64_t previous;
+    };
+
+    Environment() : parent(nullptr), functions(std::make_shared<FunctionBindings>())
     {
         // Inicia com escopo global
         enter_scope();
     }
 
     // Construtor com parent (para funções)
-    Environment(std::shared_ptr<Environment> parent) : parent(parent)
+    Environment(std::shared_ptr<Environment> parent) : parent(parent), functions(parent->functions)
     {
         // Inicia com escopo local
         enter_scope();
     }
 
+    ~Environment() override
+    {
+        untrack();
+        for (bool hasFunction : scopeHasFunction)
+        {
+            if (hasFunction)
+            {
+                functions->epoch++;
+                break;
+            }
+        }
+    }
+
+    uint64_t functionEpoch() const
+    {
+        return functions->epoch.load(std::memory_order_relaxed);
+    }
+
+    // Marca este environment e seus ancestrais como visíveis a outras
+    // threads. Deve ser chamado antes de entregar o environment a uma task.
+    void markShared()
+    {
+        functions->shared = true;
+        for (Environment *env = this; env != nullptr && !env->shared; env = env->parent.get())
+        {
+            env->shared = true;
+        }
+    }
+
     // Entra em um novo escopo (bloco)
     void enter_scope()
     {
+        auto lock = writeLock();
         scopes.push_back({});
+        scopeHasFunction.push_back(false);
     }
 
     // Sai do escopo atual (variáveis morrem)
     void exit_scope()
     {
+        auto lock = writeLock();
         if (scopes.size() > 1)
         { // Não remove o escopo global
+            if (scopeHasFunction.back())
+            {
+                functions->epoch++;
+            }
             scopes.pop_back();
+            scopeHasFunction.pop_back();
         }
     }
 
     void define(const std::string &name, std::any value, bool isConst = false)
     {
+        auto lock = writeLock();
         if (scopes.back().count(name))
         {
             throw std::runtime_error("Variable '" + name + "' has already been defined in this scope");
         }
+        bool function = isFunction(value);
+        if (function || functions->contains(name))
+        {
+            touchFunction(name, function, scopes.size() - 1);
+        }
         scopes.back()[name] = value;
         if (isConst)
         {
@@ -58,6 +260,8 @@ public:
 
     void assign(const std::string &name, std::any value)
     {
+        auto lock = writeLock();
+
         // Verifica se é constante
         if (constants.count(name))
         {
@@ -65,16 +269,25 @@ public:
         }
 
         // Procura do escopo mais interno para o mais externo
-        for (auto it = scopes.rbegin(); it != scopes.rend(); ++it)
+        for (size_t i = scopes.size(); i-- > 0;)
         {
-            if (it->count(name))
+            auto found = scopes[i].find(name);
+            if (found != scopes[i].end())
             {
-                it->at(name) = value;
+                checkWritable(name);
+                // Assign não sombreia: só importa se o valor antigo ou o novo é função
+                bool function = isFunction(value);
+                if (function || isFunction(found->second))
+                {
+                    touchFunction(name, function, i);
+                }
+                found->second = value;
                 return;
             }
         }
 
         // Se não encontrou nos escopos locais, procura no parent
+        lock = {};
         if (parent != nullptr)
         {
             parent->assign(name, value);
@@ -84,14 +297,65 @@ public:
         throw std::runtime_error("Undefined variable '" + name + "'.");
     }
 
+    // Acrescenta os trechos ao fim da string guardada em name, sem copiá-la.
+    // false (e nada muda) se a variável ou algum trecho não é string.
+    bool append(const std::string &name, const std::vector<std::any> &pieces)
+    {
+        auto lock = writeLock();
+
+        if (constants.count(name))
+        {
+            throw std::runtime_error("Cannot assign to constant '" + name + "'");
+        }
+
+        for (size_t i = scopes.size(); i-- > 0;)
+        {
+            auto found = scopes[i].find(name);
+            if (found != scopes[i].end())
+            {
+                checkWritable(name);
+                auto text = std::any_cast<String>(&found->second);
+                if (text == nullptr)
+                {
+                    return false;
+                }
+                for (const auto &piece : pieces)
+                {
+                    if (piece.type() != typeid(String))
+                    {
+                        return false;
+                    }
+                }
+                for (const auto &piece : pieces)
+                {
+                    text->append(std::any_cast<String>(&piece)->view());
+                }
+                return true;
+            }
+        }
+
+        lock = {};
+        if (parent != nullptr)
+        {
+            return parent->append(name, pieces);
+        }
+
+        throw std::runtime_error("Undefined variable '" + name + "'.");
+    }
+
     std::any get(const std::string &name)
     {
-        // Procura do escopo mais interno para o mais externo
-        for (auto it = scopes.rbegin(); it != scopes.rend(); ++it)
         {
-            if (it->count(name))
+            auto lock = readLock();
+
+            // Procura do escopo mais interno para o mais externo
+            for (auto it = scopes.rbegin(); it != scopes.rend(); ++it)
             {
-                return it->at(name);
+                auto found = it->find(name);
+                if (found != it->end())
+                {
+                    return found->second;
+                }
             }
         }
 
@@ -104,9 +368,33 @@ public:
         throw std::runtime_error("Undefined variable '" + name + "'.");
     }
 
+    // Algum escopo, deste environment até o global, define 'name'
+    bool has(const std::string &name) const
+    {
+        {
+            auto lock = readLock();
+            for (const auto &scope : scopes)
+            {
+                if (scope.count(name))
+                {
+                    return true;
+                }
+            }
+        }
+        return parent != nullptr && parent->has(name);
+    }
+
+    // Daqui em diante, definir 'name' em qualquer environment muda a época
+    // (chamadas de builtin guardam na época que nada sombreia o nome)
+    void watch(const std::string &name)
+    {
+        functions->insert(name);
+    }
+
     // Método auxiliar para verificar se uma variável existe no escopo atual
     bool exists_in_current_scope(const std::string &name)
     {
+        auto lock = readLock();
         return scopes.back().count(name) > 0;
     }
 };
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+#include <any>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+// Texto dos valores Monny, usado por print, to_string e print_to. Números
+// saem no menor texto que relê o mesmo double (std::to_chars) e arrays
+// aninhados são escritos recursivamente, tudo direto no destino, sem
+// strings intermediárias.
+class Format
+{
+public:
+    // Cabe qualquer número formatado
+    static constexpr size_t numberCapacity = 32;
+
+    // Escreve o número em buffer e retorna quantos caracteres usou.
+    // Inteiros sem ".0"; até 1e21 sem notação científica.
+    static size_t number(char *buffer, double value);
+
+    // Valor como o print mostra (a string em si sai sem aspas e sem
+    // tratar escapes; dentro de arrays, entre aspas)
+    static void write(std::ostream &stream, const std::any &value);
+    static void append(std::string &text, const std::any &value);
+};
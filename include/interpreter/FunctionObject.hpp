@@ -0,0 +1,44 @@
+#pragma once
+#include <any>
+#include <memory>
+#include <string>
+#include <vector>
+#include <parser/Stmt.hpp>
+#include <interpreter/Heap.hpp>
+
+class Environment;
+class Interpreter;
+
+// Função definida pelo usuário. Guardada no environment como
+// std::shared_ptr<FunctionObject>, então lookups e caches não a copiam.
+// A closure costuma guardar a própria função (ciclo que o Heap desfaz).
+class FunctionObject : public Collectable
+{
+public:
+    std::shared_ptr<Statements::FunctionDef> declaration;
+    std::shared_ptr<Environment> closure;
+
+    FunctionObject(std::shared_ptr<Statements::FunctionDef> declaration,
+                   std::shared_ptr<Environment> closure)
+        : declaration(declaration), closure(closure) {}
+    ~FunctionObject() override { untrack(); }
+
+    std::any call(Interpreter *interpreter, const std::vector<std::any> &arguments);
+
+    int arity() const
+    {
+        return declaration->params.size();
+    }
+
+    std::string toString() const
+    {
+        return "<fn " + declaration->name.lexeme + ">";
+    }
+
+protected:
+    void references(std::vector<Collectable *> &out) const override;
+    void clearReferences(std::vector<std::any> &dead) override
+    {
+        dead.push_back(std::move(closure));
+    }
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <any>
+#include <string>
+#include <vector>
+
+class EventLoop;
+struct Fiber;
+
+// Resultado de uma função async ou de um builtin de I/O assíncrono.
+// Pertence ao event loop da thread que o criou: só é completado e só pode
+// ser aguardado (await) nessa thread, então não precisa de lock.
+class FutureObject
+{
+public:
+    EventLoop *owner;
+    bool done = false;
+    std::any value;
+    std::string error;
+    bool failed = false;
+
+    // Fibras paradas num await deste future
+    std::vector<Fiber *> waiters;
+
+    explicit FutureObject(EventLoop *owner) : owner(owner) {}
+
+    void complete(std::any result);
+    void fail(std::string message);
+};
@@ -0,0 +1,114 @@
+#pragma once
+#include <any>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Índice de endereçamento aberto no estilo SwissTable, usado por MapObject
+// e SetObject: cada posição aponta para uma entrada no vetor do dono, e um
+// byte de controle por posição guarda 7 bits do hash. Os bytes são
+// comparados 8 de cada vez (um uint64_t), então a busca só olha as
+// entradas cujo byte bate.
+class HashIndex
+{
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // Posição cuja entrada satisfaz matches(entrada), ou npos
+    template <typename Matches>
+    size_t find(size_t hash, Matches &&matches) const
+    {
+        if (control.empty())
+        {
+            return npos;
+        }
+
+        size_t groups = control.size() / groupWidth;
+        size_t group = (hash >> 7) & (groups - 1);
+        uint8_t tag = hash & 0x7f;
+        // Sondagem triangular entre grupos: com potência de 2 passa por todos
+        for (size_t step = 1;; step++)
+        {
+            uint64_t bytes = loadGroup(&control[group * groupWidth]);
+            for (uint64_t match = matchTag(bytes, tag); match != 0; match &= match - 1)
+            {
+                size_t position = group * groupWidth + std::countr_zero(match) / 8;
+                if (matches(slots[position]))
+                {
+                    return position;
+                }
+            }
+            // Uma posição vazia encerra a busca: a chave teria ficado nela
+            if (matchEmpty(bytes) != 0)
+            {
+                return npos;
+            }
+            group = (group + step) & (groups - 1);
+        }
+    }
+
+    uint32_t entry(size_t position) const { return slots[position]; }
+
+    // Carga máxima de 7/8, contando as posições apagadas
+    bool full() const { return (used + 1) * 8 > control.size() * 7; }
+
+    // A entrada não pode estar no índice
+    void insert(uint32_t entry, size_t hash);
+
+    // Apagada e não vazia: buscas que passavam por aqui continuam adiante
+    void erase(size_t position) { control[position] = deletedControl; }
+
+    // Esvazia, com capacidade para count entradas ocupando no máximo metade
+    void reset(size_t count);
+
+    // false para o que não pode ser chave: só strings, números (menos NaN)
+    // e booleanos
+    static bool hashKey(const std::any &key, size_t &hash);
+    static size_t hashNumber(double number);
+    // Mesmo tipo e mesmo valor; a e b já passaram por hashKey
+    static bool sameKey(const std::any &a, const std::any &b);
+
+private:
+    // Bytes de controle: 0..127 = posição cheia (7 bits do hash)
+    static constexpr uint8_t emptyControl = 0x80;
+    static constexpr uint8_t deletedControl = 0xFE;
+
+    static constexpr size_t groupWidth = 8;
+    static constexpr uint64_t lowBits = 0x0101010101010101ULL;
+    static constexpr uint64_t highBits = 0x8080808080808080ULL;
+    static_assert(std::endian::native == std::endian::little, "control groups assume little endian");
+
+    // Tamanho múltiplo de groupWidth, potência de 2
+    std::vector<uint8_t> control;
+    std::vector<uint32_t> slots;
+    // Posições cheias ou apagadas: as que alongam as buscas
+    size_t used = 0;
+
+    static uint64_t loadGroup(const uint8_t *bytes)
+    {
+        uint64_t group;
+        std::memcpy(&group, bytes, sizeof(group));
+        return group;
+    }
+
+    // Bit alto de cada byte igual a tag. Pode marcar a mais um byte cheio
+    // vizinho de um que bate; a entrada é conferida depois de qualquer jeito.
+    static uint64_t matchTag(uint64_t group, uint8_t tag)
+    {
+        uint64_t bytes = group ^ (lowBits * tag);
+        return (bytes - lowBits) & ~bytes & highBits;
+    }
+
+    // 0x80 tem o bit 1 zerado, 0xFE não
+    static uint64_t matchEmpty(uint64_t group)
+    {
+        return group & ~(group << 6) & highBits;
+    }
+
+    static uint64_t matchFree(uint64_t group)
+    {
+        return group & highBits;
+    }
+};
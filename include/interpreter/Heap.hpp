@@ -0,0 +1,223 @@
+#pragma once
+#include <any>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Heap;
+
+// Elo das listas de geração do Heap
+struct HeapLink
+{
+    HeapLink *prev = nullptr;
+    HeapLink *next = nullptr;
+};
+
+// Base dos valores que podem fechar ciclos: arrays, maps, structs, funções
+// e environments. O construtor registra o objeto no heap atual da thread
+// (nenhum fora de um interpretador). Cada classe derivada chama untrack()
+// no começo do destrutor: com tasks no ar, um objeto destruído em outra
+// thread sai da lista antes de perder os campos que a coleta percorre.
+class Collectable : public HeapLink, public std::enable_shared_from_this<Collectable>
+{
+public:
+    Collectable(const Collectable &) : Collectable() {}
+    Collectable &operator=(const Collectable &) { return *this; }
+
+    // O objeto rastreável guardado no valor, ou nullptr
+    static Collectable *of(const std::any &value);
+
+protected:
+    Collectable();
+    virtual ~Collectable();
+
+    void untrack() noexcept;
+
+    // Acrescenta em 'out' cada objeto rastreável referenciado, uma vez por
+    // referência guardada
+    virtual void references(std::vector<Collectable *> &out) const = 0;
+    // Referências divididas com outros objetos (views de array): devolve
+    // quem as guarda e, em 'sharers', quantos objetos o dividem. A coleta
+    // as desconta uma vez só, e só se todos esses objetos são candidatos.
+    virtual const void *sharedReferences(size_t &sharers) const
+    {
+        (void)sharers;
+        return nullptr;
+    }
+    // O objeto é lixo: move para 'dead' o que ele referencia, desfazendo o
+    // ciclo. Os valores só são destruídos depois, fora do lock do heap.
+    virtual void clearReferences(std::vector<std::any> &dead) = 0;
+
+private:
+    friend class Heap;
+
+    Heap *heap = nullptr;
+    // Durante a coleta: referências vindas de fora dos candidatos
+    long refs = 0;
+    uint8_t generation = 0;
+    uint8_t state = 0;
+};
+
+// Coletor de ciclos de um interpretador. Os valores continuam contados por
+// std::shared_ptr, que libera quase tudo na hora; o heap só acha o que
+// sobra em ciclos. Para cada candidato, desconta do use_count as
+// referências vindas de outros candidatos: o que ainda tem referência
+// sobrando é segurado de fora (environment do interpretador, pilha de
+// chamadas, temporários, caches) e é raiz. O que as raízes não alcançam é
+// lixo.
+//
+// Duas gerações: objetos novos entram na jovem, que é coletada quando passa
+// de Limits::young objetos; sobreviventes vão para a velha, coletada junto
+// quando cresceu Limits::growth por cento desde a última coleta completa.
+//
+// Tasks e pedaços de par_* mexem nos objetos em outras threads. Antes de
+// coletar, o dono pede que parem: cada uma para no próximo safepoint
+// (entrada de função, volta de loop) ou já está numa espera (Parked). O que
+// elas seguram conta como referência de fora, então vira raiz.
+class Heap
+{
+public:
+    struct Limits
+    {
+        // 0 = sem coleta automática
+        size_t young = 1000;
+        size_t growth = 100;
+    };
+
+    struct Stats
+    {
+        size_t minor = 0;
+        size_t full = 0;
+        size_t freed = 0;
+        size_t tracked = 0;
+        double millis = 0;
+    };
+
+    Heap() = default;
+    // Objetos que sobrevivem ao heap ficam sem rastreio
+    ~Heap();
+
+    Heap(const Heap &) = delete;
+    Heap &operator=(const Heap &) = delete;
+
+    // Heap onde entram os objetos criados nesta thread
+    static Heap *current();
+
+    // Troca o heap atual da thread até o fim do escopo
+    class Scope
+    {
+    public:
+        explicit Scope(Heap *heap);
+        ~Scope();
+
+    private:
+        Heap *previous;
+    };
+
+    void setLimits(const Limits &limits) { this->limits = limits; }
+
+    // Há tasks em outras threads: daqui em diante as listas andam sob o lock
+    void share() { shared = true; }
+
+    // Enquanto vive, a thread atual roda código de uma task deste heap e a
+    // coleta espera por ela
+    class TaskScope
+    {
+    public:
+        explicit TaskScope(Heap *heap);
+        ~TaskScope();
+
+    private:
+        Heap *heap;
+        Heap *previous;
+    };
+
+    // Espera (join, canal) dentro de uma task: a coleta pode rodar enquanto
+    // isso. Fora de uma task não faz nada.
+    class Parked
+    {
+    public:
+        Parked();
+        ~Parked();
+
+    private:
+        Heap *heap;
+    };
+
+    // Chamado pelas tasks nos pontos seguros: para se o dono está coletando
+    void safepoint()
+    {
+        if (stopping.load(std::memory_order_relaxed))
+        {
+            park();
+        }
+    }
+
+    bool due() const
+    {
+        return limits.young != 0 &&
+               youngCount.load(std::memory_order_relaxed) >= limits.young + deferred.load(std::memory_order_relaxed);
+    }
+
+    // Coleta a geração jovem, e a velha também quando passou do limite
+    void collect();
+    // Coleta as duas gerações
+    void collectAll();
+
+    Stats stats() const;
+
+private:
+    // Sentinelas das listas circulares
+    HeapLink young{&young, &young};
+    HeapLink old{&old, &old};
+    // Só mudam sob o lock (quando shared); lidos sem ele por due()
+    std::atomic<size_t> youngCount{0};
+    std::atomic<size_t> oldCount{0};
+    size_t oldAfterFull = 0;
+
+    Limits limits;
+    Stats totals;
+
+    std::atomic<bool> shared{false};
+    mutable std::mutex mutex;
+
+    // Parada das tasks para a coleta
+    std::mutex stopMutex;
+    std::condition_variable stopChanged;
+    std::atomic<bool> stopping{false};
+    // Threads rodando tasks deste heap fora de um Parked (sob stopMutex)
+    size_t running = 0;
+    // Tentativa de parada que esgotou o prazo adia a próxima em 'young' objetos
+    std::atomic<size_t> deferred{0};
+
+    std::unique_lock<std::mutex> guard() const
+    {
+        return shared ? std::unique_lock<std::mutex>(mutex) : std::unique_lock<std::mutex>();
+    }
+
+    friend class Collectable;
+    void link(Collectable *object);
+    void unlink(Collectable *object);
+
+    static void bump(std::atomic<size_t> &count, long delta)
+    {
+        // Sempre sob o lock (ou numa thread só): sem instrução atômica
+        count.store(count.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    void enter();
+    void leave();
+    void park();
+    // false se alguma task não parou a tempo (I/O, builtin demorado)
+    bool stopTasks();
+    void resumeTasks();
+
+    // Passa todos os jovens para a geração velha
+    void promote();
+    // false, sem coletar, se as tasks não pararam
+    bool collectGenerations(bool full);
+};
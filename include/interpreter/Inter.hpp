@@ -2,95 +2,253 @@
 #include <vector>
 #include <memory>
 #include <any>
+#include <cstdint>
 #include <iostream>
+#include <mutex>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
 #include <parser/Expr.hpp>
 #include <parser/Stmt.hpp>
 #include <interpreter/Enviroment.hpp>
+#include <interpreter/FunctionObject.hpp>
+#include <interpreter/Heap.hpp>
+#include <interpreter/Builtins.hpp>
+#include <interpreter/Program.hpp>
+
+class Shape;
+class StructObject;
+class TaskGroup;
+class FileSinks;
 
 class Interpreter
 {
 private:
-    std::shared_ptr<Environment> environment = std::make_shared<Environment>();
+    // Coletor de ciclos. Declarado antes de tudo que guarda valores, para
+    // ser o último a sair; tasks dividem o heap de quem as criou, e só o
+    // dono coleta.
+    std::shared_ptr<Heap> heap;
+    bool ownsHeap = true;
+    std::shared_ptr<Environment> environment;
     std::any result;
 
-    class FunctionObject
-    {
-    public:
-        std::shared_ptr<Statements::FunctionDef> declaration;
-        std::shared_ptr<Environment> closure;
+    // Streams do interpretador; isolates trocam por sinks próprios
+    std::istream *in = &std::cin;
+    std::ostream *out = &std::cout;
+    std::ostream *err = &std::cerr;
+    // Criado no primeiro spawn e dividido com as tasks: cada print vira
+    // uma escrita só, sem intercalar com as outras threads
+    std::shared_ptr<std::mutex> outputLock;
+    // Criado no primeiro spawn; o dono espera por ele (waitForTasks)
+    std::shared_ptr<TaskGroup> tasks;
+    // Arquivos de print_to, fechados no fim de cada run
+    std::shared_ptr<FileSinks> files;
 
-        FunctionObject(std::shared_ptr<Statements::FunctionDef> declaration,
-                       std::shared_ptr<Environment> closure)
-            : declaration(declaration), closure(closure) {}
+    // Limites de recursão: contagem de chamadas (--max-depth) e endereço
+    // mais baixo da pilha que ainda é seguro usar
+    size_t maxDepth = 0;
+    size_t depth = 0;
+    uintptr_t stackLimit = 0;
 
-        std::any call(Interpreter *interpreter, const std::vector<std::any> &arguments);
+    // Cache de chamada por call site (FunctionCall::site): válido enquanto
+    // a época dos bindings de função não mudar. O nome chamado é uma função
+    // ou um struct (shape), nunca os dois.
+    struct CallCache
+    {
+        std::shared_ptr<FunctionObject> function;
+        std::shared_ptr<const Shape> shape;
+        uint64_t epoch = 0;
+        // Chamada de builtin sem binding de mesmo nome nesta época
+        bool builtin = false;
+    };
 
-        int arity() const
-        {
-            return declaration->params.size();
-        }
+    // Cache de campo por acesso (GetField/SetField::site): a última forma
+    // vista ali e o índice do campo nela. Guarda a forma viva, então um
+    // endereço nunca é reaproveitado por outra enquanto está no cache.
+    struct FieldCache
+    {
+        std::shared_ptr<const Shape> shape;
+        size_t slot = 0;
+    };
 
-        std::string toString() const
-        {
-            return "<fn " + declaration->name.lexeme + ">";
-        }
+    // Caches de um SiteTable (o programa ou um include()), pelo id. Tabelas
+    // de programas que já morreram saem quando entra uma nova.
+    struct SiteCaches
+    {
+        std::weak_ptr<const SiteTable> table;
+        std::vector<CallCache> calls;
+        std::vector<FieldCache> fields;
     };
+    std::unordered_map<uint64_t, SiteCaches> siteCaches;
+    // Última tabela usada: quase sempre a da próxima chamada também
+    SiteCaches *lastCaches = nullptr;
+    uint64_t lastSites = 0;
+
+    // Return pendente: blocos e loops param de executar até o
+    // callUserFunction consumir o valor (exceções custavam ~5us por chamada)
+    bool returning = false;
+    std::any returnValue;
 
-    // Usa uma exceção especial para retorno
-    class ReturnException : public std::exception
+    // O que uma task herda de quem a criou: começa no environment dele e
+    // escreve nos mesmos streams
+    struct TaskContext
     {
-    public:
-        std::any value;
-        ReturnException(std::any v) : value(v) {}
-        const char *what() const noexcept override { return "Return exception"; }
+        std::shared_ptr<Environment> environment;
+        std::istream *in;
+        std::ostream *out;
+        std::ostream *err;
+        std::shared_ptr<std::mutex> outputLock;
+        size_t maxDepth;
+        std::shared_ptr<Heap> heap;
+        std::shared_ptr<TaskGroup> tasks;
+        std::shared_ptr<FileSinks> files;
     };
 
+    // Interpretador de uma task, na thread que vai executá-la
+    explicit Interpreter(const TaskContext &context);
+
 public:
-    Interpreter() = default;
+    Interpreter();
+    ~Interpreter();
+
+    // 0 = sem limite de contagem (só a guarda da pilha)
+    void setMaxDepth(size_t limit);
+    // Endereço mais baixo da pilha da thread que vai interpretar
+    void setStackBottom(uintptr_t bottom);
+
+    void setStreams(std::istream &input, std::ostream &output, std::ostream &errors);
+    void setHeapLimits(const Heap::Limits &limits);
+    Heap::Stats heapStats() const;
+    // gc_collect(): coleta completa agora; quantos objetos liberou
+    size_t collectGarbage();
+    // Descarta globais e estado de execução, mantendo a memória já alocada
+    void reset();
+    std::istream &input() { return *in; }
+    std::ostream &output() { return *out; }
+    FileSinks &fileSinks() { return *files; }
 
-    // Interface pública principal
-    void interpret(const std::vector<std::shared_ptr<Statements::Stmt>> &statements);
+    // Interface pública principal. Retorna false se houve erro de runtime
+    bool interpret(const std::vector<std::shared_ptr<Statements::Stmt>> &statements);
+
+    // API de embedding: executa um programa compilado (definindo suas
+    // funções nos globais) e depois chama funções 'func' pelo nome.
+    // Erros de call() chegam ao host como std::runtime_error.
+    bool run(const Program &program);
+    std::any call(const std::string &name, const std::vector<std::any> &arguments);
 
     // Execução de statements
-    void execute(std::shared_ptr<Statements::Stmt> stmt);
-    void executePrint(std::shared_ptr<Statements::Print> stmt);
-    void executeExpression(std::shared_ptr<Statements::Expression> stmt);
-    void executeIf(std::shared_ptr<Statements::IF> stmt);
-    void executeVar(std::shared_ptr<Statements::Var> stmt);
-    void executeBlock(std::shared_ptr<Statements::Block> stmt);
-    void executeWhile(std::shared_ptr<Statements::While> stmt);
-    void executeClear(std::shared_ptr<Statements::Clear> stmt);
-    void executeFunctionDef(std::shared_ptr<Statements::FunctionDef> stmt);
-    void executeConst(std::shared_ptr<Statements::Const> stmt);
+    void execute(const std::shared_ptr<Statements::Stmt> &stmt);
+    void executePrint(Statements::Print *stmt);
+    void executeExpression(Statements::Expression *stmt);
+    void executeIf(Statements::IF *stmt);
+    void executeVar(Statements::Var *stmt);
+    void executeBlock(Statements::Block *stmt);
+    void executeWhile(Statements::While *stmt);
+    void executeClear(Statements::Clear *stmt);
+    void executeFunctionDef(const std::shared_ptr<Statements::FunctionDef> &stmt);
+    void executeConst(Statements::Const *stmt);
+    void executeParallelFor(Statements::ParallelFor *stmt);
+    void executeStructDef(Statements::StructDef *stmt);
 
     // Avaliação de expressões
-    std::any evaluate(std::shared_ptr<Expr> expr);
-    std::any evaluateBinary(std::shared_ptr<Binary> expr);
-    std::any evaluateLiteral(std::shared_ptr<Literal> expr);
-    std::any evaluateGrouping(std::shared_ptr<Grouping> expr);
-    std::any evaluateVariable(std::shared_ptr<Variable> expr);
-    std::any evaluateAssign(std::shared_ptr<Assign> expr);
-    std::any evaluateFunctionCall(std::shared_ptr<FunctionCall> expr);
-    std::any evaluateIncrement(std::shared_ptr<Increment> expr);
-    std::any evaluateUnary(std::shared_ptr<Unary> expr);
-    std::any evaluateLogical(std::shared_ptr<Logical> expr);
-    std::any evaluateReturn(std::shared_ptr<Return> expr);
-    std::any evaluateArrayLiteral(std::shared_ptr<ArrayLiteral> expr);
-    std::any evaluateArrayAccess(std::shared_ptr<ArrayAccess> expr);
-    std::any evaluateArrayAssign(std::shared_ptr<ArrayAssign> expr);
+    std::any evaluate(const std::shared_ptr<Expr> &expr);
+    std::any evaluateBinary(Binary *expr);
+    std::any evaluateLiteral(Literal *expr);
+    std::any evaluateGrouping(Grouping *expr);
+    std::any evaluateVariable(Variable *expr);
+    std::any evaluateAssign(Assign *expr);
+    std::any evaluateFunctionCall(FunctionCall *expr);
+    std::any evaluateIncrement(Increment *expr);
+    std::any evaluateUnary(Unary *expr);
+    std::any evaluateLogical(Logical *expr);
+    std::any evaluateReturn(Return *expr);
+    std::any evaluateArrayLiteral(ArrayLiteral *expr);
+    std::any evaluateMapLiteral(MapLiteral *expr);
+    std::any evaluateArrayAccess(ArrayAccess *expr);
+    std::any evaluateArraySlice(ArraySlice *expr);
+    std::any evaluateArrayAssign(ArrayAssign *expr);
+    std::any evaluateGetField(GetField *expr);
+    std::any evaluateSetField(SetField *expr);
+    std::any evaluateSpawn(Spawn *expr);
+    std::any evaluateAwait(Await *expr);
 
+    // Funções async devolvem um future em vez de rodar até o fim
     std::any callUserFunction(const std::string &name,
                               const std::vector<std::any> &arguments,
-                              std::shared_ptr<Statements::FunctionDef> funcDef);
+                              Statements::FunctionDef *funcDef);
+
+    // Elementos/iterações por pedaço em par_* e parallel for. Fixo, e não
+    // derivado do número de threads, para reduções darem o mesmo resultado
+    // em qualquer máquina.
+    static constexpr size_t parallelChunk = 1024;
+    // Iterações de um parallel for: cada pedaço tem uma task e um parcial
+    static constexpr size_t maxParallelIterations = parallelChunk << 20;
+
+    // Divide [0, count) em pedaços de 'chunk' e roda body(worker, begin, end)
+    // de cada um no pool do processo, num interpretador de task. Retorna
+    // quando todos terminam; o primeiro erro (na ordem dos pedaços) é relançado.
+    void parallelChunks(size_t count, size_t chunk,
+                        const std::function<void(Interpreter &, size_t, size_t)> &body);
 
     std::any executeFile(const std::string &filename);
-    std::string processEscapeSequences(const std::string& str);
+    // Escreve como o print: strings com as sequências de escape
+    // processadas direto no stream, o resto via Format
+    void writeValue(std::ostream &stream, const std::any &value);
+    static void writeEscaped(std::ostream &stream, std::string_view str);
+    std::string stringify(std::any value);
+    // Regra de verdade do if e do while (também a do par_filter)
+    bool isTruthy(std::any value);
 
 private:
     // Funções auxiliares
-    bool isTruthy(std::any value);
     bool isEqual(std::any a, std::any b);
     void checkNumberOperand(const Token &oper, std::any operand);
     void checkNumberOperands(const Token &oper, std::any left, std::any right);
-    std::string stringify(std::any value);
+    // '+' de números ou de strings
+    static std::any add(std::any left, std::any right);
+    CallCache resolveCallee(FunctionCall *expr);
+    std::shared_ptr<FunctionObject> resolveFunction(FunctionCall *expr);
+    // A chamada resolvida para builtin pelo parser não foi sombreada por uma
+    // função de include(), variável ou parâmetro de mesmo nome
+    bool builtinVisible(FunctionCall *expr);
+    std::any construct(const std::shared_ptr<const Shape> &shape,
+                       const std::vector<std::shared_ptr<Expr>> &arguments);
+    // Índice do campo 'name' na forma, pelo cache do site
+    size_t fieldSlot(const std::shared_ptr<const Shape> &shape, const std::shared_ptr<SiteTable> &sites,
+                     size_t site, const Token &name);
+    SiteCaches &cachesFor(const std::shared_ptr<SiteTable> &sites)
+    {
+        if (lastCaches != nullptr && lastSites == sites->id)
+        {
+            return *lastCaches;
+        }
+        return switchCaches(sites);
+    }
+    SiteCaches &switchCaches(const std::shared_ptr<SiteTable> &sites);
+    void clearCaches();
+    static StructObject &structOperand(const std::any &value);
+    TaskContext shareWithTasks();
+    // Só no interpretador dono: espera as tasks que ainda usam os streams
+    void waitForTasks();
+    // Ponto seguro: entrada de função e volta de loop. O dono coleta ali;
+    // as tasks param ali enquanto o dono coleta.
+    void collectIfDue()
+    {
+        if (!ownsHeap)
+        {
+            heap->safepoint();
+        }
+        else if (heap->due())
+        {
+            heap->collect();
+        }
+    }
+    std::any runFunction(const std::string &name,
+                         const std::vector<std::any> &arguments,
+                         Statements::FunctionDef *funcDef);
+    std::any startAsync(const std::string &name,
+                        const std::vector<std::any> &arguments,
+                        Statements::FunctionDef *funcDef);
+    std::any callBuiltin(const Builtin &builtin, const std::vector<std::shared_ptr<Expr>> &arguments);
+    bool stackExhausted();
 };
\ No newline at end of file
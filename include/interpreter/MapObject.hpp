@@ -0,0 +1,84 @@
+#pragma once
+#include <interpreter/HashIndex.hpp>
+#include <interpreter/Heap.hpp>
+#include <any>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Dicionário do Monny: {chave: valor} e map(). Chaves são strings, números
+// ou booleanos. As entradas ficam num vetor na ordem de inserção (a de
+// keys() e do print) e o HashIndex aponta para elas.
+class MapObject : public Collectable
+{
+public:
+    // Ligada no primeiro spawn, como ArrayObject::concurrent
+    inline static std::atomic<bool> concurrent{false};
+
+    MapObject() = default;
+    ~MapObject() override { untrack(); }
+
+    size_t size() const;
+
+    // false se a chave não existe (value não muda)
+    bool get(const std::any &key, std::any &value) const;
+    void set(const std::any &key, std::any value);
+    bool has(const std::any &key) const;
+    bool remove(const std::any &key);
+    std::vector<std::any> keys() const;
+
+    // Percorre os pares na ordem de inserção. Com tasks no ar percorre uma
+    // cópia, para não segurar este lock enquanto visit trava outros objetos.
+    template <typename Visitor>
+    void forEach(Visitor &&visit) const
+    {
+        if (!concurrent)
+        {
+            for (const auto &entry : entries)
+            {
+                if (entry.key.has_value())
+                {
+                    visit(entry.key, entry.value);
+                }
+            }
+            return;
+        }
+        for (const auto &[key, value] : snapshot())
+        {
+            visit(key, value);
+        }
+    }
+
+protected:
+    void references(std::vector<Collectable *> &out) const override;
+    void clearReferences(std::vector<std::any> &dead) override;
+
+private:
+    struct Entry
+    {
+        // Vazia: entrada removida, esperando a próxima compactação
+        std::any key;
+        std::any value;
+        size_t hash;
+    };
+
+    std::vector<Entry> entries;
+    size_t live = 0;
+    HashIndex index;
+
+    mutable std::mutex mutex;
+
+    std::unique_lock<std::mutex> guard() const
+    {
+        return concurrent ? std::unique_lock<std::mutex>(mutex) : std::unique_lock<std::mutex>();
+    }
+
+    static size_t hashKey(const std::any &key);
+    // Posição da chave no índice, ou HashIndex::npos
+    size_t find(const std::any &key, size_t hash) const;
+    // Compacta as entradas e refaz o índice com folga para mais uma
+    void rebuild();
+    std::vector<std::pair<std::any, std::any>> snapshot() const;
+};
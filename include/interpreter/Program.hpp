@@ -0,0 +1,15 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <parser/Stmt.hpp>
+
+// Código Monny já tokenizado e parseado. Não muda depois de compilado, então
+// pode ser executado várias vezes (e por vários interpretadores).
+class Program
+{
+public:
+    std::vector<std::shared_ptr<Statements::Stmt>> statements;
+
+    Program(std::vector<std::shared_ptr<Statements::Stmt>> statements)
+        : statements(std::move(statements)) {}
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <interpreter/String.hpp>
+
+// Leitor de linhas de open_read. Arquivos comuns são mapeados inteiros
+// (mmap) e cada linha é copiada uma única vez, direto do mapeamento para a
+// string Monny. Pipes e afins caem na leitura em blocos.
+//
+// As linhas não são views sobre o mapeamento: String teria de segurar o
+// mmap vivo (e o close() deixaria de poder desmapear), o que pede um terceiro
+// tipo de armazenamento em String. Fica para quando houver esse tipo.
+class ReaderObject
+{
+private:
+    std::mutex mutex;
+    int fd = -1;
+
+    // Caminho mmap
+    const char *data = nullptr;
+    size_t size = 0;
+    size_t position = 0;
+
+    // Caminho em blocos
+    std::vector<char> buffer;
+    size_t bufferStart = 0;
+    size_t bufferEnd = 0;
+    bool eof = false;
+
+    bool fill();
+    void release();
+
+public:
+    std::string path;
+
+    // Lança std::runtime_error se o arquivo não abre
+    explicit ReaderObject(const std::string &path);
+    ~ReaderObject();
+
+    ReaderObject(const ReaderObject &) = delete;
+    ReaderObject &operator=(const ReaderObject &) = delete;
+
+    // Próxima linha sem o '\n' (e sem '\r' final); false no fim do arquivo
+    bool readLine(String &line);
+    void close();
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <interpreter/HashIndex.hpp>
+#include <any>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Conjunto do Monny: set(). Elementos são strings, números ou booleanos,
+// guardados na ordem de inserção e achados pelo HashIndex. Enquanto só tem
+// números, os elementos ficam num buffer de double (removido = NaN, que não
+// pode ser elemento) e as buscas comparam doubles direto, sem std::any; o
+// primeiro não número rebaixa para o armazenamento genérico, de vez.
+class SetObject
+{
+public:
+    // Ligada no primeiro spawn, como ArrayObject::concurrent
+    inline static std::atomic<bool> concurrent{false};
+
+    SetObject() = default;
+    // Sem repetidos, na ordem da primeira ocorrência
+    SetObject(const double *values, size_t count);
+    explicit SetObject(const std::vector<std::any> &values);
+
+    size_t size() const;
+
+    // false se já estava
+    bool add(const std::any &value);
+    bool has(const std::any &value) const;
+    bool remove(const std::any &value);
+    std::vector<std::any> elements() const;
+
+    // Conjuntos novos; a ordem segue a de 'left', depois a de 'right'
+    static std::shared_ptr<SetObject> unite(const SetObject &left, const SetObject &right);
+    static std::shared_ptr<SetObject> intersect(const SetObject &left, const SetObject &right);
+    static std::shared_ptr<SetObject> difference(const SetObject &left, const SetObject &right);
+
+    // Percorre na ordem de inserção. Com tasks no ar percorre uma cópia.
+    template <typename Visitor>
+    void forEach(Visitor &&visit) const
+    {
+        if (!concurrent)
+        {
+            forEachLive([&](size_t entry) { visit(valueAt(entry)); });
+            return;
+        }
+        for (const auto &element : elements())
+        {
+            visit(element);
+        }
+    }
+
+private:
+    std::vector<double> numbers;
+    std::vector<std::any> values;
+    bool numeric = true;
+    size_t live = 0;
+    HashIndex index;
+
+    mutable std::mutex mutex;
+
+    std::unique_lock<std::mutex> guard() const
+    {
+        return concurrent ? std::unique_lock<std::mutex>(mutex) : std::unique_lock<std::mutex>();
+    }
+
+    // Chamada com o lock de other
+    void copyFrom(const SetObject &other);
+
+    size_t entryCount() const { return numeric ? numbers.size() : values.size(); }
+    bool isLive(size_t entry) const;
+    std::any valueAt(size_t entry) const;
+
+    template <typename Visitor>
+    void forEachLive(Visitor &&visit) const
+    {
+        for (size_t entry = 0; entry < entryCount(); entry++)
+        {
+            if (isLive(entry))
+            {
+                visit(entry);
+            }
+        }
+    }
+
+    static size_t hashElement(const std::any &value);
+    static size_t hashNumber(double number);
+    size_t findNumber(double number, size_t hash) const;
+    // Posição no índice, ou HashIndex::npos
+    size_t find(const std::any &value, size_t hash) const;
+
+    // Sem lock; false se já estava
+    bool insert(const std::any &value);
+    bool insertNumber(double number, size_t hash);
+    // Sem procurar antes: o valor não pode estar no conjunto
+    void appendNumber(double number, size_t hash);
+    void append(const std::any &value, size_t hash);
+
+    // Os elementos de left que estão (keep) ou não estão em right. Como
+    // left não tem repetidos, entram no resultado sem procurar.
+    static std::shared_ptr<SetObject> filter(const SetObject &left, const SetObject &right, bool keep);
+
+    void demote();
+    // Compacta os elementos e refaz o índice com espaço para 'extra' a mais
+    void rebuild(size_t extra);
+};
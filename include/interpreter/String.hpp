@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// String do Monny. Imutável para quem a vê e compartilhada por referência:
+// o handle tem 8 bytes e cabe no armazenamento interno do std::any, então
+// copiar um valor string (get, argumento, elemento de array) nunca copia
+// caracteres. Até 7 bytes o texto fica dentro do próprio handle; maiores
+// vão num bloco com contagem de referências, tamanho e hash guardados.
+class String
+{
+public:
+    static constexpr size_t inlineCapacity = sizeof(uintptr_t) - 1;
+
+    String() noexcept : bits(inlineTag) {}
+    String(std::string_view text);
+    String(const std::string &text) : String(std::string_view(text)) {}
+    String(const char *text) : String(std::string_view(text)) {}
+
+    String(const String &other) noexcept : bits(other.bits)
+    {
+        retain();
+    }
+
+    String(String &&other) noexcept : bits(other.bits)
+    {
+        other.bits = inlineTag;
+    }
+
+    String &operator=(const String &other) noexcept
+    {
+        if (this != &other)
+        {
+            other.retain();
+            release();
+            bits = other.bits;
+        }
+        return *this;
+    }
+
+    String &operator=(String &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            bits = other.bits;
+            other.bits = inlineTag;
+        }
+        return *this;
+    }
+
+    ~String()
+    {
+        release();
+    }
+
+    size_t size() const noexcept
+    {
+        return isInline() ? (bits & 0xff) >> 1 : block()->size;
+    }
+
+    const char *data() const noexcept
+    {
+        return isInline() ? reinterpret_cast<const char *>(&bits) + 1 : block()->characters();
+    }
+
+    std::string_view view() const noexcept { return {data(), size()}; }
+    std::string str() const { return std::string(view()); }
+
+    // Calculado uma vez por bloco
+    size_t hash() const noexcept;
+
+    // Mesmo bloco: iguais sem olhar os caracteres. Hashes já calculados e
+    // diferentes: diferentes sem olhar os caracteres.
+    bool operator==(const String &other) const noexcept;
+
+    static String concat(std::string_view left, std::string_view right);
+
+    // Cresce no lugar quando este handle é o único dono do bloco (ninguém
+    // mais vê a mudança); senão copia para um bloco novo com folga
+    void append(std::string_view text);
+
+private:
+    struct Block
+    {
+        std::atomic<uint32_t> references;
+        mutable std::atomic<size_t> hash;
+        size_t size;
+        size_t capacity;
+
+        char *characters() noexcept { return reinterpret_cast<char *>(this + 1); }
+    };
+
+    // Bit baixo 1: texto no handle, tamanho nos bits 1-3 do primeiro byte.
+    // Senão: ponteiro para o Block (sempre alinhado).
+    static constexpr uintptr_t inlineTag = 1;
+    static_assert(std::endian::native == std::endian::little, "inline strings assume little endian");
+
+    uintptr_t bits;
+
+    bool isInline() const noexcept { return (bits & inlineTag) != 0; }
+    Block *block() const noexcept { return reinterpret_cast<Block *>(bits); }
+
+    void retain() const noexcept
+    {
+        if (!isInline())
+        {
+            block()->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void release() noexcept;
+    static Block *allocate(size_t size, size_t capacity);
+};
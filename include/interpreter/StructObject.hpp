@@ -0,0 +1,66 @@
+#pragma once
+#include <interpreter/Heap.hpp>
+#include <any>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Forma (hidden class) de um struct: o nome e os campos na ordem declarada.
+// Cada 'struct' executado cria uma forma; como os campos são fixos, todas as
+// instâncias dela têm o mesmo layout, e o índice de um campo achado uma vez
+// vale para qualquer outra. No environment fica como std::shared_ptr<Shape>
+// e chamá-la constrói uma instância: Point(1, 2).
+class Shape
+{
+public:
+    std::string name;
+    std::vector<std::string> fields;
+
+    Shape(std::string name, std::vector<std::string> fields)
+        : name(std::move(name)), fields(std::move(fields)) {}
+
+    // Índice do campo ou npos. Busca linear: só roda quando o cache do
+    // acesso erra.
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    size_t slot(const std::string &field) const;
+};
+
+// Instância de um struct: os campos ficam contíguos, na ordem da forma.
+class StructObject : public Collectable
+{
+public:
+    // Ligada no primeiro spawn, como ArrayObject::concurrent
+    inline static std::atomic<bool> concurrent{false};
+
+    // values tem um valor por campo da forma
+    StructObject(std::shared_ptr<const Shape> shape, std::vector<std::any> values)
+        : type(std::move(shape)), fields(std::move(values)) {}
+    ~StructObject() override { untrack(); }
+
+    // A forma não muda depois de criada: lida sem lock
+    const Shape &shape() const { return *type; }
+    const std::shared_ptr<const Shape> &sharedShape() const { return type; }
+
+    std::any get(size_t slot) const;
+    void set(size_t slot, std::any value);
+    // Cópia dos campos, para percorrer sem segurar o lock
+    std::vector<std::any> values() const;
+
+protected:
+    void references(std::vector<Collectable *> &out) const override;
+    void clearReferences(std::vector<std::any> &dead) override;
+
+private:
+    std::shared_ptr<const Shape> type;
+    std::vector<std::any> fields;
+
+    mutable std::mutex mutex;
+
+    std::unique_lock<std::mutex> guard() const
+    {
+        return concurrent ? std::unique_lock<std::mutex>(mutex) : std::unique_lock<std::mutex>();
+    }
+};
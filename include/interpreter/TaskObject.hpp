@@ -0,0 +1,125 @@
+#pragma once
+#include <any>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include <interpreter/Heap.hpp>
+#include <runtime/ThreadPool.hpp>
+
+// Handle devolvido por spawn. A task roda no pool do processo; join espera
+// o resultado ajudando a esvaziar o pool, então tasks que fazem join em
+// outras tasks não prendem os workers.
+class TaskObject
+{
+private:
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+    std::any result;
+    std::string error;
+
+    bool isDone()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return done;
+    }
+
+public:
+    void complete(std::any value)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            result = std::move(value);
+            done = true;
+        }
+        finished.notify_all();
+    }
+
+    void fail(std::string message)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            error = std::move(message);
+            done = true;
+        }
+        finished.notify_all();
+    }
+
+    std::any join()
+    {
+        ThreadPool &pool = ThreadPool::shared();
+        if (!isDone())
+        {
+            // Dentro de uma task, o heap dela pode coletar durante a espera
+            Heap::Parked parked;
+            while (!isDone())
+            {
+                if (!pool.runPending())
+                {
+                    // Nada para ajudar: a task está rodando em outro worker
+                    std::unique_lock<std::mutex> lock(mutex);
+                    finished.wait_for(lock, std::chrono::microseconds(200), [this]() { return done; });
+                }
+            }
+        }
+
+        // Depois de 'done' o resultado não muda mais
+        if (!error.empty())
+        {
+            throw std::runtime_error(error);
+        }
+        return result;
+    }
+};
+
+// Tasks ainda rodando de um interpretador, contando as criadas por outras
+// tasks dele. Elas escrevem nos streams do dono, então o dono espera por
+// elas antes de sair de run() ou de ser destruído.
+class TaskGroup
+{
+private:
+    std::mutex mutex;
+    std::condition_variable idle;
+    size_t running = 0;
+
+public:
+    void begin()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running++;
+    }
+
+    // Última coisa que a task faz com o que é do dono
+    void end()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0)
+        {
+            idle.notify_all();
+        }
+    }
+
+    // Como join: ajuda o pool enquanto espera
+    void wait()
+    {
+        ThreadPool &pool = ThreadPool::shared();
+        for (;;)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (running == 0)
+                {
+                    return;
+                }
+            }
+            if (!pool.runPending())
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                idle.wait_for(lock, std::chrono::microseconds(200), [this]() { return running == 0; });
+            }
+        }
+    }
+};
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <any>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -20,13 +22,32 @@ public:
     Literal(std::any value) : value(value) {}
 };
 
+// Sites de cache de um parse (o programa ou um include()), numerados a
+// partir de 0 em cada um. O interpretador guarda os caches por tabela,
+// pelo id, que não se repete no processo: um programa novo pode ocupar o
+// endereço de um que já morreu.
+class SiteTable
+{
+public:
+    const uint64_t id = nextId++;
+    size_t calls = 0;
+    size_t fields = 0;
+
+private:
+    inline static std::atomic<uint64_t> nextId{1};
+};
+
 class FunctionCall : public Expr {
 public:
     std::shared_ptr<Expr> callee;  // Mude de Token para shared_ptr<Expr>
     std::vector<std::shared_ptr<Expr>> arguments;
-    
-    FunctionCall(std::shared_ptr<Expr> callee, std::vector<std::shared_ptr<Expr>> arguments)
-        : callee(callee), arguments(arguments) {}
+    int builtin = -1;  // Índice em Builtins, resolvido pelo parser; vale se nenhum binding sombrear o nome
+    size_t site;       // Slot do cache de chamada em 'sites'
+    std::shared_ptr<SiteTable> sites;
+
+    FunctionCall(std::shared_ptr<Expr> callee, std::vector<std::shared_ptr<Expr>> arguments,
+                 std::shared_ptr<SiteTable> table)
+        : callee(callee), arguments(arguments), site(table->calls++), sites(std::move(table)) {}
 };
 
 class Variable : public Expr
@@ -60,6 +81,9 @@ class Assign : public Expr
 public:
     Token name;
     std::shared_ptr<Expr> value;
+    // Em `s = s + a + b`, os trechos a, b. Preenchido pelo parser só quando
+    // eles não podem reatribuir s, para o interpretador acrescentar no lugar.
+    std::vector<std::shared_ptr<Expr>> appended;
 
     Assign(Token name, std::shared_ptr<Expr> value) : name(name), value(value) {}
 };
@@ -115,6 +139,16 @@ public:
         : elements(elements) {}
 };
 
+// Literal de dicionário: {"a": 1, chave: valor}
+class MapLiteral : public Expr {
+public:
+    std::vector<std::shared_ptr<Expr>> keys;
+    std::vector<std::shared_ptr<Expr>> values;
+
+    MapLiteral(std::vector<std::shared_ptr<Expr>> keys, std::vector<std::shared_ptr<Expr>> values)
+        : keys(keys), values(values) {}
+};
+
 // Acesso a array: arr[0]
 class ArrayAccess : public Expr {
 public:
@@ -125,6 +159,17 @@ public:
         : array(array), index(index) {}
 };
 
+// Trecho de array: arr[a:b], arr[:b], arr[a:] (limites ausentes = nullptr)
+class ArraySlice : public Expr {
+public:
+    std::shared_ptr<Expr> array;
+    std::shared_ptr<Expr> start;
+    std::shared_ptr<Expr> end;
+
+    ArraySlice(std::shared_ptr<Expr> array, std::shared_ptr<Expr> start, std::shared_ptr<Expr> end)
+        : array(array), start(start), end(end) {}
+};
+
 // Atribuição a array: arr[0] = 5
 class ArrayAssign : public Expr {
 public:
@@ -134,4 +179,51 @@ public:
     
     ArrayAssign(std::shared_ptr<Expr> array, std::shared_ptr<Expr> index, std::shared_ptr<Expr> value)
         : array(array), index(index), value(value) {}
-};
\ No newline at end of file
+};
+// Campo de struct: p.x. 'site' é o slot do cache de campo em 'sites'
+// (forma vista por último e índice do campo nela).
+class GetField : public Expr {
+public:
+    std::shared_ptr<Expr> object;
+    Token name;
+    size_t site;
+    std::shared_ptr<SiteTable> sites;
+
+    GetField(std::shared_ptr<Expr> object, Token name, std::shared_ptr<SiteTable> table)
+        : object(object), name(name), site(table->fields++), sites(std::move(table)) {}
+};
+
+// Atribuição a campo: p.x = 5
+class SetField : public Expr {
+public:
+    std::shared_ptr<Expr> object;
+    Token name;
+    std::shared_ptr<Expr> value;
+    size_t site;
+    std::shared_ptr<SiteTable> sites;
+
+    // Divide a numeração de campos com GetField
+    SetField(std::shared_ptr<Expr> object, Token name, std::shared_ptr<Expr> value,
+             std::shared_ptr<SiteTable> table)
+        : object(object), name(name), value(value), site(table->fields++), sites(std::move(table)) {}
+};
+
+// Task paralela: spawn f(args)
+class Spawn : public Expr {
+public:
+    Token keyword;
+    std::shared_ptr<FunctionCall> call;
+
+    Spawn(Token keyword, std::shared_ptr<FunctionCall> call)
+        : keyword(keyword), call(call) {}
+};
+
+// Espera um future (função async, I/O assíncrono) ou uma task: await x
+class Await : public Expr {
+public:
+    Token keyword;
+    std::shared_ptr<Expr> value;
+
+    Await(Token keyword, std::shared_ptr<Expr> value)
+        : keyword(keyword), value(value) {}
+};
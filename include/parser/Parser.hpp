@@ -2,6 +2,7 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <tokenizer/Token.hpp>
 
 class Expr;
@@ -16,6 +17,7 @@ class Return;
 class ArrayAccess;
 class ArrayAssign;
 class ArrayLiteral;
+class SiteTable;
 
 namespace Statements {
     class Stmt;
@@ -29,12 +31,28 @@ namespace Statements {
     class For;
     class FunctionDef;
     class Const;
+    class ParallelFor;
+    class StructDef;
 }
 
+class FunctionCall;
+class Assign;
+
 class Parser {
 private:
     std::vector<Token> tokens;
     size_t current = 0;
+    // Numeração dos caches de chamada e de campo deste parse
+    std::shared_ptr<SiteTable> sites;
+
+    // Funções 'func' do programa sombreiam builtins de mesmo nome. Como
+    // podem ser definidas depois do uso, as chamadas resolvidas para
+    // builtins são revistas no fim do parse. Funções de include(), variáveis
+    // e parâmetros só o interpretador vê (Interpreter::builtinVisible).
+    std::unordered_set<std::string> userFunctions;
+    std::vector<std::shared_ptr<FunctionCall>> builtinCalls;
+    std::vector<std::shared_ptr<Assign>> appendAssigns;
+    void resolveShadowedBuiltins();
     
     // Funções auxiliares
     bool isAtEnd();
@@ -60,6 +78,7 @@ private:
     std::shared_ptr<Expr> basicPrimary();
     std::shared_ptr<Expr> unary();
     std::shared_ptr<Expr> arrayLiteral();
+    std::shared_ptr<Expr> mapLiteral();
     std::shared_ptr<Expr> call();
     std::shared_ptr<Expr> finishArrayAccess(std::shared_ptr<Expr> array);
 
@@ -74,8 +93,18 @@ private:
     std::shared_ptr<Statements::Stmt> incrementStatement();
     std::shared_ptr<Statements::Clear> clearStatement();
     std::shared_ptr<Statements::Stmt> forStatement();
+    std::shared_ptr<Statements::ParallelFor> parallelForStatement();
+    void checkParallelBody(const std::shared_ptr<Statements::Stmt> &stmt,
+                           std::unordered_set<std::string> &locals,
+                           const std::unordered_set<std::string> &reductions);
+    void checkParallelBody(const std::shared_ptr<Expr> &expr,
+                           std::unordered_set<std::string> &locals,
+                           const std::unordered_set<std::string> &reductions);
+    void detectAppend(Assign &assign);
+    static bool rebindsNothing(const std::shared_ptr<Expr> &expr);
     std::shared_ptr<Statements::FunctionDef> functionStatement();
     std::shared_ptr<Statements::Const> constStatement();
+    std::shared_ptr<Statements::StructDef> structStatement();
     
     // Funções
     std::shared_ptr<Expr> finishFunctionCall(std::shared_ptr<Expr> callee);
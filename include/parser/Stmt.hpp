@@ -93,17 +93,55 @@ namespace Statements
               increment(increment), body(body) {}
     };
 
+    // parallel for (def i = inicio; i < fim; i++) reduce(+: soma) { ... }
+    // O corpo só escreve em variáveis declaradas nele, em arrays e nas
+    // variáveis de redução (cada worker tem uma cópia própria)
+    class ParallelFor : public Stmt
+    {
+    public:
+        struct Reduction
+        {
+            Token oper; // +, * ou o identificador min/max
+            Token name;
+        };
+
+        Token variable;
+        std::shared_ptr<Expr> start;
+        std::shared_ptr<Expr> end;
+        bool inclusive;
+        std::vector<Reduction> reductions;
+        std::shared_ptr<Block> body;
+
+        ParallelFor(Token variable, std::shared_ptr<Expr> start, std::shared_ptr<Expr> end,
+                    bool inclusive, std::vector<Reduction> reductions, std::shared_ptr<Block> body)
+            : variable(variable), start(start), end(end), inclusive(inclusive),
+              reductions(std::move(reductions)), body(body) {}
+    };
+
     class FunctionDef : public Stmt
     {
     public:
         Token name;
         std::vector<Token> params;
         std::shared_ptr<Block> body;
+        // async func: a chamada devolve um future e o corpo roda numa fibra
+        bool isAsync = false;
 
         FunctionDef(Token name, std::vector<Token> params, std::shared_ptr<Block> body)
             : name(name), params(params), body(body) {}
     };
 
+    // struct Point { x, y }: campos fixos, na ordem declarada
+    class StructDef : public Stmt
+    {
+    public:
+        Token name;
+        std::vector<Token> fields;
+
+        StructDef(Token name, std::vector<Token> fields)
+            : name(name), fields(std::move(fields)) {}
+    };
+
     class Const : public Stmt {
 public:
     Token name;
@@ -0,0 +1,114 @@
+#pragma once
+#include <any>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <ucontext.h>
+
+#include <interpreter/FutureObject.hpp>
+
+// Função async do Monny rodando numa pilha própria. O interpretador é
+// recursivo, então o corpo não pode ser uma corrotina C++ sem pilha: a
+// fibra guarda a pilha inteira e volta para quem a retomou em cada await.
+struct Fiber
+{
+    ucontext_t context;
+    ucontext_t caller;
+    void *stack = nullptr;
+    size_t stackSize = 0;
+    std::function<void(uintptr_t stackBottom)> body;
+    bool finished = false;
+};
+
+// Corrotina C++ disparada e esquecida: as operações de I/O dos builtins
+// são escritas assim e completam um FutureObject no fim
+struct Job
+{
+    struct promise_type
+    {
+        Job get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// Event loop de uma thread, sobre epoll. Timers (timerfd) e processos
+// (pidfd) são esperados direto no epoll; leitura de arquivo comum, que o
+// epoll não suporta, roda no pool de threads e volta por um eventfd.
+class EventLoop
+{
+public:
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop &) = delete;
+    EventLoop &operator=(const EventLoop &) = delete;
+
+    // Loop da thread atual, criado no primeiro uso
+    static EventLoop &current();
+    // nullptr se a thread ainda não usou async
+    static EventLoop *existing();
+
+    // Operações assíncronas dos builtins
+    std::shared_ptr<FutureObject> sleep(double milliseconds);
+    std::shared_ptr<FutureObject> readFile(const std::string &path);
+    std::shared_ptr<FutureObject> runProcess(const std::string &command);
+
+    // Roda body numa fibra nova até o primeiro await
+    void startFiber(std::function<void(uintptr_t stackBottom)> body);
+    // Numa fibra, suspende até o future completar; fora de uma, roda o
+    // loop até lá. Relança o erro do future como std::runtime_error.
+    std::any await(const std::shared_ptr<FutureObject> &future);
+    // Roda até não sobrar fibra pronta nem operação pendente
+    void drain();
+
+    // Chamado por FutureObject::complete
+    void wake(Fiber *fiber);
+
+    // Awaitables das corrotinas
+    struct Readable
+    {
+        EventLoop &loop;
+        int fd;
+        bool await_ready() const noexcept { return false; }
+        // false (segue sem esperar) se o fd não pôde entrar no epoll
+        bool await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {}
+    };
+    struct Offload
+    {
+        EventLoop &loop;
+        std::function<void()> work;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {}
+    };
+    Readable readable(int fd) { return {*this, fd}; }
+    Offload offload(std::function<void()> work) { return {*this, std::move(work)}; }
+
+private:
+    int epollFd;
+    int wakeFd;
+    // Fds no epoll + trabalhos no pool ainda não concluídos
+    size_t pending = 0;
+
+    std::mutex completionMutex;
+    std::vector<std::coroutine_handle<>> completions;
+
+    std::deque<Fiber *> ready;
+    Fiber *currentFiber = nullptr;
+    std::vector<void *> freeStacks;
+
+    void resume(Fiber *fiber);
+    void suspend();
+    void poll();
+    void destroy(Fiber *fiber);
+    static void fiberEntry();
+};
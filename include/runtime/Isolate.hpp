@@ -0,0 +1,42 @@
+#pragma once
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <interpreter/Inter.hpp>
+#include <interpreter/Program.hpp>
+#include <runtime/ThreadPool.hpp>
+
+// Interpretador isolado: globais, valores e saída próprios. Só o Program
+// (imutável) e o registro de builtins são compartilhados entre isolates,
+// então cada um pode rodar numa thread diferente.
+class Isolate
+{
+public:
+    struct Result
+    {
+        bool ok = false;
+        std::string output;
+        std::string errors;
+    };
+
+    Isolate();
+
+    // Executa na thread atual; pode ser chamado várias vezes
+    bool run(const Program &program);
+    Result result() const;
+
+    Interpreter &interpreter() { return inter; }
+    std::ostream &errors() { return errorStream; }
+
+    // Executa cada programa num isolate próprio, distribuídos pelo pool
+    static std::vector<Result> runAll(const std::vector<std::shared_ptr<const Program>> &programs,
+                                      ThreadPool &pool);
+
+private:
+    std::istringstream input; // sem stdin: input() lê vazio
+    std::ostringstream output;
+    std::ostringstream errorStream;
+    Interpreter inter;
+    bool ok = true;
+};
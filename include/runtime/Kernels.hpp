@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+
+// Laços numéricos dos builtins de array (sum, dot, add...) sobre buffers
+// de double. Em x86-64 com AVX2 rodam em vetores de 4 doubles; a escolha
+// é feita uma vez, pela CPU em que o processo está, e as outras máquinas
+// usam a versão escalar. As reduções somam na mesma ordem nas duas
+// versões, então o resultado não muda de uma máquina para outra.
+class Kernels
+{
+public:
+    enum class Comparison
+    {
+        Greater,
+        Less,
+        Equal,
+    };
+
+    // "avx2" ou "scalar"
+    static const char *instructionSet();
+
+    static double sum(const double *values, size_t count);
+    // count > 0
+    static double min(const double *values, size_t count);
+    static double max(const double *values, size_t count);
+    static double dot(const double *left, const double *right, size_t count);
+
+    // out pode ser um dos operandos
+    static void add(const double *left, const double *right, double *out, size_t count);
+    static void addScalar(const double *values, double scalar, double *out, size_t count);
+    static void mul(const double *left, const double *right, double *out, size_t count);
+    static void scale(const double *values, double factor, double *out, size_t count);
+    static void cumsum(const double *values, double *out, size_t count);
+
+    // Máscara: 1 onde a comparação vale, 0 onde não
+    static void compare(Comparison comparison, const double *left, const double *right,
+                        double *out, size_t count);
+    static void compareScalar(Comparison comparison, const double *values, double scalar,
+                              double *out, size_t count);
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+
+// Quando o conteúdo do buffer vai para o fd
+enum class FlushPolicy
+{
+    // A cada '\n' (terminal: a linha aparece assim que é impressa)
+    Line,
+    // Só quando o buffer enche, no flush explícito ou no fim (pipe, arquivo)
+    Size,
+};
+
+// Buffer de escrita sobre um fd. Fica por baixo do std::cout no executável
+// e por baixo dos arquivos de print_to/write_file: as escritas se juntam
+// num bloco de 64 KB e cada bloco vira um único write.
+class OutputBuffer : public std::streambuf
+{
+public:
+    static constexpr size_t capacity = 64 * 1024;
+
+    OutputBuffer(int fd, FlushPolicy policy, bool ownsFd);
+    // Descarrega o que sobrou e fecha o fd se for dele
+    ~OutputBuffer() override;
+
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    // Abre o arquivo para escrita, no fim (append) ou truncado.
+    // Lança std::runtime_error se não abre.
+    static std::unique_ptr<OutputBuffer> open(const std::string &path, bool append);
+
+    // Põe um OutputBuffer do stdout por baixo do std::cout até o fim do
+    // processo. Sem política: Line se o stdout é um terminal, senão Size.
+    static void installStandard();
+    static void installStandard(FlushPolicy policy);
+
+    // false se o write falhou
+    bool flush();
+
+protected:
+    int_type overflow(int_type character) override;
+    std::streamsize xsputn(const char *data, std::streamsize count) override;
+    int sync() override;
+
+private:
+    std::mutex mutex;
+    int fd;
+    bool ownsFd;
+    FlushPolicy policy;
+    std::unique_ptr<char[]> buffer;
+    size_t used = 0;
+    std::streambuf *replaced = nullptr;
+
+    bool drain();
+    bool writeAll(const char *data, size_t count);
+};
+
+// Arquivos abertos por print_to: prints seguidos no mesmo caminho se juntam
+// no mesmo buffer. Cada interpretador tem os seus (divididos com as tasks)
+// e os fecha no fim do run, então um --serve não acumula descritores.
+class FileSinks
+{
+public:
+    // Escreve no buffer do caminho, abrindo o arquivo (no fim) no primeiro uso
+    void write(const std::string &path, const std::function<void(std::ostream &)> &writer);
+    // Descarrega e fecha o arquivo do caminho, se aberto (write_file vai sobrescrevê-lo)
+    void forget(const std::string &path);
+    // Antes de ler um arquivo, o que foi impresso nele precisa estar no disco.
+    // Lança std::runtime_error se algum write falhou.
+    void flush();
+    // Como flush, mas fecha todos os arquivos
+    void close();
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<OutputBuffer>> open;
+};
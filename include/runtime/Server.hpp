@@ -0,0 +1,58 @@
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <interpreter/Program.hpp>
+#include <runtime/ThreadPool.hpp>
+
+// Servidor local num Unix domain socket. Cada conexão manda um pedido:
+//
+//   RUN <caminho>\n            executa um arquivo
+//   EVAL <bytes>\n<código>     executa o código enviado
+//
+// A saída do script (stdout e stderr) volta pela conexão enquanto é
+// produzida, seguida de um byte NUL e do status de saída: "\0<status>\n".
+// Os programs parseados ficam em cache e cada worker reutiliza o mesmo
+// interpretador entre pedidos.
+class Server
+{
+public:
+    // Cliente que fica esse tempo sem mandar nada perde a conexão, para
+    // não segurar um worker
+    static constexpr int receiveTimeoutSeconds = 10;
+    // Limites do pedido: linha de cabeçalho e código de um EVAL
+    static constexpr size_t maxHeaderBytes = 4096;
+    static constexpr size_t maxEvalBytes = 16 * 1024 * 1024;
+    // Cache de EVAL: só guarda códigos pequenos e limita o total em bytes
+    static constexpr size_t maxCachedSourceBytes = 64 * 1024;
+    static constexpr size_t maxSourceCacheBytes = 16 * 1024 * 1024;
+    static constexpr size_t maxCachedSources = 1024;
+
+    Server(const std::string &socketPath, size_t threads = 0);
+    ~Server();
+
+    // Aceita conexões até o processo ser encerrado
+    int serve();
+
+private:
+    struct CachedFile
+    {
+        std::filesystem::file_time_type modified;
+        std::shared_ptr<const Program> program;
+    };
+
+    std::string socketPath;
+    int listener = -1;
+    ThreadPool pool;
+
+    std::mutex cacheMutex;
+    std::unordered_map<std::string, CachedFile> files;
+    std::unordered_map<std::string, std::shared_ptr<const Program>> sources;
+    size_t sourceBytes = 0;
+
+    void handle(int client);
+    std::shared_ptr<const Program> programForFile(const std::string &path);
+    std::shared_ptr<const Program> programForSource(const std::string &source);
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool fixo de threads com roubo de trabalho: cada worker tem sua própria
+// fila, consome do fim (LIFO) e, quando fica sem trabalho, rouba do começo
+// da fila dos outros. Tarefas enviadas de dentro de um worker vão para a
+// fila dele.
+class ThreadPool
+{
+public:
+    // 0 = uma thread por núcleo
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // A tarefa não deve lançar exceções
+    void submit(std::function<void()> task);
+    // Bloqueia até todas as tarefas enviadas terminarem (não chamar de um worker)
+    void wait();
+    // Executa uma tarefa pendente na thread atual, se houver. Usado por quem
+    // espera um resultado (join) para não bloquear um worker à toa.
+    bool runPending();
+
+    // Um worker que vai bloquear esperando outra thread (canal cheio/vazio)
+    // avisa antes. Se com isso nenhum worker sobrar para as tarefas na fila,
+    // o pool cria um extra, que termina assim que não achar mais tarefa.
+    // Chamados de fora de um worker não fazem nada.
+    void beginBlocking();
+    void endBlocking();
+
+    // Pool do processo, criado no primeiro uso (tasks de spawn)
+    static ThreadPool &shared();
+
+    size_t size() const { return queues.size(); }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // Worker criado por compensate; 'done' quando já saiu do laço
+    struct Extra
+    {
+        std::thread thread;
+        bool done = false;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    // Sob sleepMutex
+    std::list<Extra> extras;
+    size_t liveExtras = 0;
+
+    std::mutex sleepMutex;
+    std::condition_variable available;
+    std::condition_variable idle;
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> nextQueue{0};
+    bool stopping = false;
+    // Workers bloqueados entre beginBlocking e endBlocking (sob sleepMutex)
+    size_t blocked = 0;
+
+    bool runOne(size_t self);
+    void compensate();
+    void work(size_t index, Extra *extra);
+};
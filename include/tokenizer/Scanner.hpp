@@ -50,7 +50,12 @@ private:
     {"input", TokenType::INPUT},
     {"to_number", TokenType::TO_NUMBER},
     {"clear", TokenType::CLEAR},
-    {"const", TokenType::CONST}
+    {"const", TokenType::CONST},
+    {"spawn", TokenType::SPAWN},
+    {"parallel", TokenType::PARALLEL},
+    {"async", TokenType::ASYNC},
+    {"await", TokenType::AWAIT},
+    {"struct", TokenType::STRUCT}
   };
 
 public:
@@ -19,6 +19,11 @@ enum class TokenType
   TRUE,
   FALSE,
   CONST,
+  SPAWN,
+  PARALLEL,
+  ASYNC,
+  AWAIT,
+  STRUCT,
 
   TO_STRING,
   INPUT,
@@ -34,6 +39,7 @@ enum class TokenType
   RIGHT_BRACKET,
   COMMA,
   DOT,
+  COLON,
   MINUS,
   PLUS,
   STAR,
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Executa uma função numa pilha alocada no heap (mmap), em vez da pilha
+// nativa da thread principal. A região é apenas reservada: as páginas só
+// são usadas quando tocadas, então a pilha cresce sob demanda.
+class HeapStack
+{
+public:
+    // Bytes reservados por nível de chamada Monny no modo --max-depth
+    static constexpr size_t frameBudget = 16 * 1024;
+    // Folga deixada no fim da pilha para desempilhar a exceção e reportar o
+    // erro; o interpretador para de chamar funções ao chegar nela
+    static constexpr size_t margin = 1024 * 1024;
+
+    // Pilha para maxDepth níveis mais a folga (satura em vez de estourar)
+    static size_t sizeFor(size_t maxDepth)
+    {
+        constexpr size_t limit = (SIZE_MAX / 2 - margin) / frameBudget;
+        return (maxDepth < limit ? maxDepth : limit) * frameBudget + margin;
+    }
+
+    static void run(size_t size, const std::function<void()> &fn);
+
+    // Endereço mais baixo da pilha da thread atual (principal, de pool ou
+    // criada por run)
+    static uintptr_t bottom();
+};
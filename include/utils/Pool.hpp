@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Alocador dos objetos do runtime (arrays, environments, strings, funções).
+// Cada tamanho até maxSize é arredondado para uma classe; cada thread tem
+// uma lista livre por classe e pega blocos novos de páginas de slabSize
+// bytes, cortadas uma vez e nunca devolvidas ao sistema. Alocar e liberar
+// na mesma thread não trava nada. Um bloco liberado em outra thread entra
+// na lista dela; listas que crescem demais (e as de threads que terminam)
+// voltam para a lista global da classe, de onde qualquer thread reabastece
+// quando acaba a sua página.
+//
+// Tamanhos acima de maxSize vão direto para o ::operator new.
+class Pool
+{
+public:
+    static constexpr size_t maxSize = 512;
+    static constexpr size_t slabSize = 64 * 1024;
+
+    struct ClassStats
+    {
+        // Tamanho dos blocos da classe
+        size_t size = 0;
+        size_t allocations = 0;
+        size_t frees = 0;
+        // Bytes em páginas da classe (usados ou livres)
+        size_t reserved = 0;
+    };
+
+    static void *allocate(size_t size);
+    // size tem que ser o mesmo passado ao allocate
+    static void deallocate(void *block, size_t size) noexcept;
+
+    // Uma entrada por classe, em ordem de tamanho. Contagens de outras
+    // threads podem estar um pouco atrasadas.
+    static std::vector<ClassStats> stats();
+};
+
+// Para std::allocate_shared e containers: objeto e bloco de controle do
+// shared_ptr saem juntos de uma classe do Pool
+template <typename T>
+struct PoolAllocator
+{
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+    T *allocate(size_t count)
+    {
+        static_assert(alignof(T) <= 16, "Pool blocks are only 16-byte aligned");
+        return static_cast<T *>(Pool::allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T *block, size_t count) noexcept
+    {
+        Pool::deallocate(block, count * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> &) const noexcept { return true; }
+};
+
+// std::make_shared pelo Pool
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args &&...args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
@@ -1,27 +1,51 @@
 #include <Monny.hpp>
 #include <string>
 #include <utils/Systems.hpp>
+#include <utils/HeapStack.hpp>
+#include <utils/Pool.hpp>
 #include <tokenizer/Scanner.hpp>
 #include <parser/Parser.hpp>
 #include <parser/Expr.hpp>
 #include <parser/Stmt.hpp>
 #include <interpreter/Inter.hpp>
+#include <runtime/Isolate.hpp>
+#include <runtime/ThreadPool.hpp>
+#include <runtime/Server.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sysexits.h>
 
 namespace fs = std::filesystem;
 
-void Monny::runScriptFile(const std::string &path)
+Monny::Options Monny::options;
+
+void Monny::loadExtension(const std::string &path)
 {
-	if (!fs::exists(path))
+	try
 	{
-		std::cout << "[ERROR]: file not found.\n";
+		Builtins::load(path);
+	}
+	catch (const std::runtime_error &error)
+	{
+		std::cout << "[ERROR]: " << error.what() << "\n";
 		std::exit(66);
 	}
+}
+
+int Monny::readScript(const std::string &path, std::string &source, std::ostream &errors)
+{
+	if (!fs::exists(path))
+	{
+		errors << "[ERROR]: file not found.\n";
+		return EX_NOINPUT;
+	}
 
 	std::ifstream file(path, std::ios::binary | std::ios::ate);
 	if (!file)
 	{
-		std::cout << "[ERROR]: permission reading file.\n";
-		std::exit(66);
+		errors << "[ERROR]: permission reading file.\n";
+		return EX_NOINPUT;
 	}
 
 	std::streamsize size = file.tellg();
@@ -31,11 +55,142 @@ void Monny::runScriptFile(const std::string &path)
 
 	if (!file.read((char *)buffer.data(), size))
 	{
-		std::cout << "[ERROR]: file is not complete.\n";
+		errors << "[ERROR]: file is not complete.\n";
+	}
+
+	source.assign(buffer.begin(), buffer.end());
+	return EX_OK;
+}
+
+void Monny::runScriptFile(const std::string &path)
+{
+	std::string source;
+	int status = readScript(path, source, std::cout);
+	if (status != EX_OK)
+	{
+		std::exit(status);
+	}
+	status = run(source);
+	if (status != EX_OK)
+	{
+		std::cout.flush();
+		std::exit(status);
+	}
+}
+
+int Monny::runScriptFile(const std::string &path, Isolate &isolate)
+{
+	std::string source;
+	int status = readScript(path, source, isolate.errors());
+	if (status != EX_OK)
+	{
+		return status;
+	}
+
+	std::shared_ptr<const Program> program;
+	try
+	{
+		program = compile(source);
+	}
+	catch (const std::runtime_error &error)
+	{
+		isolate.errors() << "Syntax error: " << error.what() << "\n";
+		return EX_DATAERR;
+	}
+
+	isolate.interpreter().setMaxDepth(options.maxDepth);
+	isolate.interpreter().setHeapLimits(options.heap);
+	return isolate.run(*program) ? EX_OK : EX_SOFTWARE;
+}
+
+int Monny::runBatch(const std::string &target)
+{
+	// Diretório: todos os .mn dele; senão um arquivo com um caminho por linha
+	std::vector<std::string> paths;
+	if (fs::is_directory(target))
+	{
+		for (const auto &entry : fs::directory_iterator(target))
+		{
+			if (entry.is_regular_file() && entry.path().extension() == ".mn")
+			{
+				paths.push_back(entry.path().string());
+			}
+		}
+		std::sort(paths.begin(), paths.end());
+	}
+	else
+	{
+		std::ifstream list(target);
+		if (!list)
+		{
+			std::cout << "[ERROR]: batch list not found.\n";
+			return EX_NOINPUT;
+		}
+		std::string line;
+		while (std::getline(list, line))
+		{
+			if (!line.empty())
+			{
+				paths.push_back(line);
+			}
+		}
+	}
+
+	struct Entry
+	{
+		int status = EX_OK;
+		double millis = 0;
+		Isolate::Result result;
+	};
+	std::vector<Entry> entries(paths.size());
+
+	using Clock = std::chrono::steady_clock;
+	auto batchStart = Clock::now();
+
+	ThreadPool pool;
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		pool.submit([&paths, &entries, i]()
+		{
+			auto start = Clock::now();
+			Isolate isolate;
+			entries[i].status = runScriptFile(paths[i], isolate);
+			entries[i].millis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			entries[i].result = isolate.result();
+		});
 	}
+	pool.wait();
+
+	double totalMillis = std::chrono::duration<double, std::milli>(Clock::now() - batchStart).count();
+
+	// Saídas capturadas, na ordem dos scripts
+	size_t failed = 0;
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		std::cout << "==> " << paths[i] << " <==\n"
+				  << entries[i].result.output << entries[i].result.errors;
+		if (entries[i].status != EX_OK)
+		{
+			failed++;
+		}
+	}
+
+	std::cout << "\n-- batch: " << paths.size() << " scripts, " << failed << " failed, "
+			  << pool.size() << " threads, " << std::fixed << std::setprecision(1)
+			  << totalMillis << " ms\n";
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		std::cout << std::setw(10) << entries[i].millis << " ms  exit " << std::setw(2)
+				  << entries[i].status << "  " << paths[i] << "\n";
+	}
+
+	return failed == 0 ? EX_OK : EXIT_FAILURE;
+}
 
-	std::string source(buffer.begin(), buffer.end());
-	run(source);
+int Monny::serve(const std::string &socketPath)
+{
+	Server server(socketPath);
+	return server.serve();
 }
 
 void Monny::runREPL()
@@ -62,14 +217,71 @@ void Monny::runREPL()
 	}
 }
 
-void Monny::run(const std::string &source)
+std::shared_ptr<const Program> Monny::compile(const std::string &source)
 {
 	Scanner scanner(source);
 	std::vector<Token> tokens = scanner.scanTokens();
 
 	Parser parser(tokens);
-	auto statements = parser.parse();
+	return std::make_shared<const Program>(parser.parse());
+}
+
+int Monny::run(const std::string &source)
+{
+	std::shared_ptr<const Program> program;
+	try
+	{
+		program = compile(source);
+	}
+	catch (const std::runtime_error &error)
+	{
+		std::cout.flush();
+		std::cerr << "Syntax error: " << error.what() << "\n";
+		return EX_DATAERR;
+	}
 
 	Interpreter inter;
-	inter.interpret(statements);
+	inter.setHeapLimits(options.heap);
+	bool ok = false;
+	if (options.maxDepth == 0)
+	{
+		inter.setStackBottom(HeapStack::bottom());
+		ok = inter.run(*program);
+	}
+	else
+	{
+		// Modo --max-depth: a recursão roda numa pilha reservada no heap
+		size_t stackSize = HeapStack::sizeFor(options.maxDepth);
+		HeapStack::run(stackSize, [&]()
+		{
+			inter.setMaxDepth(options.maxDepth);
+			inter.setStackBottom(HeapStack::bottom());
+			ok = inter.run(*program);
+		});
+	}
+
+	if (options.gcStats)
+	{
+		Heap::Stats stats = inter.heapStats();
+		std::cout.flush();
+		std::cerr << "[gc] " << stats.minor << " minor, " << stats.full << " full, "
+				  << stats.freed << " freed, " << stats.tracked << " tracked, "
+				  << std::fixed << std::setprecision(1) << stats.millis << " ms\n";
+	}
+
+	if (options.allocStats)
+	{
+		std::cout.flush();
+		for (const Pool::ClassStats &entry : Pool::stats())
+		{
+			if (entry.allocations == 0)
+			{
+				continue;
+			}
+			std::cerr << "[alloc] " << entry.size << " B: " << entry.allocations << " allocs, "
+					  << entry.allocations - entry.frees << " live, "
+					  << entry.reserved / 1024 << " KB reserved\n";
+		}
+	}
+	return ok ? EX_OK : EX_SOFTWARE;
 }
\ No newline at end of file
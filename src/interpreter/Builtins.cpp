@@ -0,0 +1,808 @@
+#include <interpreter/Builtins.hpp>
+#include <interpreter/Inter.hpp>
+#include <interpreter/ArrayObject.hpp>
+#include <interpreter/MapObject.hpp>
+#include <interpreter/SetObject.hpp>
+#include <interpreter/TaskObject.hpp>
+#include <interpreter/ChannelObject.hpp>
+#include <interpreter/ReaderObject.hpp>
+#include <interpreter/String.hpp>
+#include <runtime/EventLoop.hpp>
+#include <runtime/Output.hpp>
+#include <runtime/Kernels.hpp>
+#include <utils/Pool.hpp>
+#include <interpreter/FunctionObject.hpp>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include <dlfcn.h>
+
+static std::any builtinInput(Interpreter &inter, std::span<const std::any> args)
+{
+    std::istream &in = inter.input();
+    inter.output() << inter.stringify(args[0]) << std::flush;
+
+    if (in.peek() == '\n')
+    {
+        in.ignore();
+    }
+
+    std::string input;
+    std::getline(in, input);
+
+    input.erase(0, input.find_first_not_of(" \t\n\r\f\v"));
+    input.erase(input.find_last_not_of(" \t\n\r\f\v") + 1);
+
+    return String(input);
+}
+
+static std::any builtinToString(Interpreter &inter, std::span<const std::any> args)
+{
+    return String(inter.stringify(args[0]));
+}
+
+static std::any builtinToNumber(Interpreter &, std::span<const std::any> args)
+{
+    if (auto text = std::any_cast<String>(&args[0]))
+    {
+        try
+        {
+            return std::stod(text->str());
+        }
+        catch (...)
+        {
+            throw std::runtime_error("Cannot convert string to number");
+        }
+    }
+    return args[0];
+}
+
+static std::any builtinLen(Interpreter &, std::span<const std::any> args)
+{
+    if (auto array = std::any_cast<std::shared_ptr<ArrayObject>>(&args[0]))
+    {
+        return static_cast<double>((*array)->size());
+    }
+    if (auto str = std::any_cast<String>(&args[0]))
+    {
+        return static_cast<double>(str->size());
+    }
+    if (auto map = std::any_cast<std::shared_ptr<MapObject>>(&args[0]))
+    {
+        return static_cast<double>((*map)->size());
+    }
+    if (auto set = std::any_cast<std::shared_ptr<SetObject>>(&args[0]))
+    {
+        return static_cast<double>((*set)->size());
+    }
+    throw std::runtime_error("len() expects array, string, map or set");
+}
+
+static std::any builtinFloat64Array(Interpreter &, std::span<const std::any> args)
+{
+    // Testado antes da conversão: NaN, infinito ou acima de size_t seriam UB
+    static const double maxSize = static_cast<double>(std::vector<double>().max_size());
+    auto size = std::any_cast<double>(&args[0]);
+    if (size == nullptr || !(*size >= 0 && *size <= maxSize) || *size != std::floor(*size))
+    {
+        throw std::runtime_error("float64_array() expects a non-negative integer size");
+    }
+    size_t count = static_cast<size_t>(*size);
+    try
+    {
+        return makePooled<ArrayObject>(std::vector<double>(count, 0.0), true);
+    }
+    catch (const std::exception &)
+    {
+        // bad_alloc ou length_error: não chegariam ao script como runtime_error
+        throw std::runtime_error("float64_array() cannot allocate " + std::to_string(count) + " numbers");
+    }
+}
+
+namespace
+{
+    // Números de um argumento array: direto do buffer quando possível
+    struct Numbers
+    {
+        std::vector<double> copy;
+        const double *data = nullptr;
+        size_t count = 0;
+    };
+}
+
+static Numbers numbersArgument(const char *builtin, const std::any &value)
+{
+    Numbers numbers;
+    auto array = std::any_cast<std::shared_ptr<ArrayObject>>(&value);
+    if (array == nullptr || !(*array)->numbersView(numbers.copy, numbers.data, numbers.count))
+    {
+        throw std::runtime_error(std::string(builtin) + "() expects an array of numbers");
+    }
+    return numbers;
+}
+
+// Segundo operando de add/mul/comparações: array do mesmo tamanho ou número
+static Numbers sameLengthArgument(const char *builtin, const std::any &value, size_t count)
+{
+    Numbers numbers = numbersArgument(builtin, value);
+    if (numbers.count != count)
+    {
+        throw std::runtime_error(std::string(builtin) + "() expects arrays of the same length");
+    }
+    return numbers;
+}
+
+static std::any builtinSum(Interpreter &, std::span<const std::any> args)
+{
+    Numbers values = numbersArgument("sum", args[0]);
+    return Kernels::sum(values.data, values.count);
+}
+
+static std::any builtinMin(Interpreter &, std::span<const std::any> args)
+{
+    Numbers values = numbersArgument("min", args[0]);
+    if (values.count == 0)
+    {
+        throw std::runtime_error("min() of empty array");
+    }
+    return Kernels::min(values.data, values.count);
+}
+
+static std::any builtinMax(Interpreter &, std::span<const std::any> args)
+{
+    Numbers values = numbersArgument("max", args[0]);
+    if (values.count == 0)
+    {
+        throw std::runtime_error("max() of empty array");
+    }
+    return Kernels::max(values.data, values.count);
+}
+
+static std::any builtinDot(Interpreter &, std::span<const std::any> args)
+{
+    Numbers left = numbersArgument("dot", args[0]);
+    Numbers right = sameLengthArgument("dot", args[1], left.count);
+    return Kernels::dot(left.data, right.data, left.count);
+}
+
+static std::any builtinAdd(Interpreter &, std::span<const std::any> args)
+{
+    // add(s, v) em conjunto: insere, true se v não estava
+    if (auto set = std::any_cast<std::shared_ptr<SetObject>>(&args[0]))
+    {
+        return (*set)->add(args[1]);
+    }
+    Numbers left = numbersArgument("add", args[0]);
+    std::vector<double> result(left.count);
+    if (auto scalar = std::any_cast<double>(&args[1]))
+    {
+        Kernels::addScalar(left.data, *scalar, result.data(), left.count);
+    }
+    else
+    {
+        Numbers right = sameLengthArgument("add", args[1], left.count);
+        Kernels::add(left.data, right.data, result.data(), left.count);
+    }
+    return makePooled<ArrayObject>(std::move(result));
+}
+
+static std::any builtinMul(Interpreter &, std::span<const std::any> args)
+{
+    Numbers left = numbersArgument("mul", args[0]);
+    std::vector<double> result(left.count);
+    if (auto scalar = std::any_cast<double>(&args[1]))
+    {
+        Kernels::scale(left.data, *scalar, result.data(), left.count);
+    }
+    else
+    {
+        Numbers right = sameLengthArgument("mul", args[1], left.count);
+        Kernels::mul(left.data, right.data, result.data(), left.count);
+    }
+    return makePooled<ArrayObject>(std::move(result));
+}
+
+static std::any builtinScale(Interpreter &, std::span<const std::any> args)
+{
+    Numbers values = numbersArgument("scale", args[0]);
+    auto factor = std::any_cast<double>(&args[1]);
+    if (factor == nullptr)
+    {
+        throw std::runtime_error("scale() expects a number as factor");
+    }
+    std::vector<double> result(values.count);
+    Kernels::scale(values.data, *factor, result.data(), values.count);
+    return makePooled<ArrayObject>(std::move(result));
+}
+
+static std::any builtinCumsum(Interpreter &, std::span<const std::any> args)
+{
+    Numbers values = numbersArgument("cumsum", args[0]);
+    std::vector<double> result(values.count);
+    Kernels::cumsum(values.data, result.data(), values.count);
+    return makePooled<ArrayObject>(std::move(result));
+}
+
+static std::any compareArrays(const char *builtin, Kernels::Comparison comparison, std::span<const std::any> args)
+{
+    Numbers left = numbersArgument(builtin, args[0]);
+    std::vector<double> mask(left.count);
+    if (auto scalar = std::any_cast<double>(&args[1]))
+    {
+        Kernels::compareScalar(comparison, left.data, *scalar, mask.data(), left.count);
+    }
+    else
+    {
+        Numbers right = sameLengthArgument(builtin, args[1], left.count);
+        Kernels::compare(comparison, left.data, right.data, mask.data(), left.count);
+    }
+    return makePooled<ArrayObject>(std::move(mask));
+}
+
+static std::any builtinGreater(Interpreter &, std::span<const std::any> args)
+{
+    return compareArrays("greater", Kernels::Comparison::Greater, args);
+}
+
+static std::any builtinLess(Interpreter &, std::span<const std::any> args)
+{
+    return compareArrays("less", Kernels::Comparison::Less, args);
+}
+
+static std::any builtinEqual(Interpreter &, std::span<const std::any> args)
+{
+    return compareArrays("equal", Kernels::Comparison::Equal, args);
+}
+
+static std::any builtinPush(Interpreter &, std::span<const std::any> args)
+{
+    if (auto array = std::any_cast<std::shared_ptr<ArrayObject>>(&args[0]))
+    {
+        (*array)->push(args[1]);
+        return args[1];
+    }
+    throw std::runtime_error("push() expects array as first argument");
+}
+
+static std::any builtinPop(Interpreter &, std::span<const std::any> args)
+{
+    if (auto array = std::any_cast<std::shared_ptr<ArrayObject>>(&args[0]))
+    {
+        return (*array)->pop();
+    }
+    throw std::runtime_error("pop() expects array");
+}
+
+static std::any builtinSlice(Interpreter &, std::span<const std::any> args)
+{
+    auto array = std::any_cast<std::shared_ptr<ArrayObject>>(&args[0]);
+    auto start = std::any_cast<double>(&args[1]);
+    auto end = std::any_cast<double>(&args[2]);
+    if (array == nullptr || start == nullptr || end == nullptr)
+    {
+        throw std::runtime_error("slice() expects array, start and end");
+    }
+    return (*array)->slice(static_cast<long>(*start), static_cast<long>(*end));
+}
+
+static std::any builtinMap(Interpreter &, std::span<const std::any>)
+{
+    return makePooled<MapObject>();
+}
+
+static MapObject &mapArgument(const char *builtin, const std::any &value)
+{
+    auto map = std::any_cast<std::shared_ptr<MapObject>>(&value);
+    if (map == nullptr)
+    {
+        throw std::runtime_error(std::string(builtin) + "() expects a map");
+    }
+    return **map;
+}
+
+// nil se a chave não existe
+static std::any builtinGet(Interpreter &, std::span<const std::any> args)
+{
+    std::any value = nullptr;
+    mapArgument("get", args[0]).get(args[1], value);
+    return value;
+}
+
+// set() cria um conjunto vazio, set(array) um com os valores do array e
+// set(m, k, v) guarda no dicionário
+static std::any builtinSet(Interpreter &, std::span<const std::any> args)
+{
+    if (args.size() == 3)
+    {
+        mapArgument("set", args[0]).set(args[1], args[2]);
+        return args[2];
+    }
+    if (args.size() == 2)
+    {
+        throw std::runtime_error("set() expects 0 or 1 arguments for a new set, or 3 to store in a map");
+    }
+    if (args.empty())
+    {
+        return makePooled<SetObject>();
+    }
+
+    auto array = std::any_cast<std::shared_ptr<ArrayObject>>(&args[0]);
+    if (array == nullptr)
+    {
+        throw std::runtime_error("set() expects an array");
+    }
+    // Arrays numéricos vão direto do buffer de double
+    std::vector<double> copy;
+    const double *numbers = nullptr;
+    size_t count = 0;
+    if ((*array)->numbersView(copy, numbers, count))
+    {
+        return makePooled<SetObject>(numbers, count);
+    }
+    return makePooled<SetObject>((*array)->snapshot());
+}
+
+static std::any builtinHas(Interpreter &, std::span<const std::any> args)
+{
+    if (auto set = std::any_cast<std::shared_ptr<SetObject>>(&args[0]))
+    {
+        return (*set)->has(args[1]);
+    }
+    if (auto map = std::any_cast<std::shared_ptr<MapObject>>(&args[0]))
+    {
+        return (*map)->has(args[1]);
+    }
+    throw std::runtime_error("has() expects a map or set");
+}
+
+static std::any builtinRemove(Interpreter &, std::span<const std::any> args)
+{
+    if (auto set = std::any_cast<std::shared_ptr<SetObject>>(&args[0]))
+    {
+        return (*set)->remove(args[1]);
+    }
+    if (auto map = std::any_cast<std::shared_ptr<MapObject>>(&args[0]))
+    {
+        return (*map)->remove(args[1]);
+    }
+    throw std::runtime_error("remove() expects a map or set");
+}
+
+// Chaves de um map ou elementos de um set, num array
+static std::any builtinKeys(Interpreter &, std::span<const std::any> args)
+{
+    if (auto set = std::any_cast<std::shared_ptr<SetObject>>(&args[0]))
+    {
+        return makePooled<ArrayObject>((*set)->elements());
+    }
+    return makePooled<ArrayObject>(mapArgument("keys", args[0]).keys());
+}
+
+static std::pair<const SetObject *, const SetObject *> setArguments(const char *builtin, std::span<const std::any> args)
+{
+    auto left = std::any_cast<std::shared_ptr<SetObject>>(&args[0]);
+    auto right = std::any_cast<std::shared_ptr<SetObject>>(&args[1]);
+    if (left == nullptr || right == nullptr)
+    {
+        throw std::runtime_error(std::string(builtin) + "() expects two sets");
+    }
+    return {left->get(), right->get()};
+}
+
+static std::any builtinUnion(Interpreter &, std::span<const std::any> args)
+{
+    auto [left, right] = setArguments("union", args);
+    return SetObject::unite(*left, *right);
+}
+
+static std::any builtinIntersect(Interpreter &, std::span<const std::any> args)
+{
+    auto [left, right] = setArguments("intersect", args);
+    return SetObject::intersect(*left, *right);
+}
+
+static std::any builtinDifference(Interpreter &, std::span<const std::any> args)
+{
+    auto [left, right] = setArguments("difference", args);
+    return SetObject::difference(*left, *right);
+}
+
+static std::any builtinJoin(Interpreter &, std::span<const std::any> args)
+{
+    if (auto task = std::any_cast<std::shared_ptr<TaskObject>>(&args[0]))
+    {
+        return (*task)->join();
+    }
+    throw std::runtime_error("join() expects a task");
+}
+
+static std::shared_ptr<ChannelObject> channelArgument(const char *builtin, const std::any &value)
+{
+    if (auto channel = std::any_cast<std::shared_ptr<ChannelObject>>(&value))
+    {
+        return *channel;
+    }
+    throw std::runtime_error(std::string(builtin) + "() expects a channel");
+}
+
+static std::any builtinChannel(Interpreter &, std::span<const std::any> args)
+{
+    // Testado antes da conversão, como em float64_array()
+    auto capacity = std::any_cast<double>(&args[0]);
+    if (capacity == nullptr || !(*capacity >= 1 && *capacity <= ChannelObject::maxCapacity) ||
+        *capacity != std::floor(*capacity))
+    {
+        throw std::runtime_error("channel() capacity must be an integer from 1 to " +
+                                 std::to_string(ChannelObject::maxCapacity));
+    }
+    size_t count = static_cast<size_t>(*capacity);
+    try
+    {
+        return std::make_shared<ChannelObject>(count);
+    }
+    catch (const std::bad_alloc &)
+    {
+        throw std::runtime_error("channel() cannot allocate " + std::to_string(count) + " cells");
+    }
+}
+
+static std::any builtinSend(Interpreter &, std::span<const std::any> args)
+{
+    channelArgument("send", args[0])->send(args[1]);
+    return args[1];
+}
+
+static std::any builtinRecv(Interpreter &, std::span<const std::any> args)
+{
+    return channelArgument("recv", args[0])->recv();
+}
+
+static std::any builtinClose(Interpreter &, std::span<const std::any> args)
+{
+    if (auto reader = std::any_cast<std::shared_ptr<ReaderObject>>(&args[0]))
+    {
+        (*reader)->close();
+        return nullptr;
+    }
+    channelArgument("close", args[0])->close();
+    return nullptr;
+}
+
+static std::string pathArgument(const char *builtin, const std::any &value)
+{
+    if (auto path = std::any_cast<String>(&value))
+    {
+        return path->str();
+    }
+    throw std::runtime_error(std::string(builtin) + "() expects a string path");
+}
+
+static std::any builtinPrintTo(Interpreter &inter, std::span<const std::any> args)
+{
+    // Os valores seguem juntos, como num print
+    std::string path = pathArgument("print_to", args[0]);
+    inter.fileSinks().write(path, [&](std::ostream &stream)
+    {
+        for (const auto &value : args.subspan(1))
+        {
+            inter.writeValue(stream, value);
+        }
+    });
+    return nullptr;
+}
+
+static std::any builtinWriteFile(Interpreter &inter, std::span<const std::any> args)
+{
+    std::string path = pathArgument("write_file", args[0]);
+    // Um print_to pendente no mesmo arquivo seria escrito por cima
+    inter.fileSinks().forget(path);
+
+    auto sink = OutputBuffer::open(path, false);
+    std::ostream stream(sink.get());
+    inter.writeValue(stream, args[1]);
+    if (!sink->flush())
+    {
+        throw std::runtime_error("Cannot write file: " + path);
+    }
+    return nullptr;
+}
+
+static std::any builtinOpenRead(Interpreter &inter, std::span<const std::any> args)
+{
+    std::string path = pathArgument("open_read", args[0]);
+    inter.fileSinks().flush();
+    return std::make_shared<ReaderObject>(path);
+}
+
+static std::any builtinReadLine(Interpreter &, std::span<const std::any> args)
+{
+    auto reader = std::any_cast<std::shared_ptr<ReaderObject>>(&args[0]);
+    if (reader == nullptr)
+    {
+        throw std::runtime_error("read_line() expects a reader from open_read()");
+    }
+    String line;
+    if (!(*reader)->readLine(line))
+    {
+        return nullptr;
+    }
+    return line;
+}
+
+static std::any builtinLines(Interpreter &inter, std::span<const std::any> args)
+{
+    std::string path = pathArgument("lines", args[0]);
+    inter.fileSinks().flush();
+    ReaderObject reader(path);
+    std::vector<std::any> result;
+    String line;
+    while (reader.readLine(line))
+    {
+        result.emplace_back(std::move(line));
+    }
+    return makePooled<ArrayObject>(std::move(result));
+}
+
+static std::shared_ptr<ArrayObject> arrayArgument(const char *builtin, const std::any &value)
+{
+    if (auto array = std::any_cast<std::shared_ptr<ArrayObject>>(&value))
+    {
+        return *array;
+    }
+    throw std::runtime_error(std::string(builtin) + "() expects array as first argument");
+}
+
+static std::shared_ptr<FunctionObject> functionArgument(const char *builtin, const std::any &value, int arity)
+{
+    auto function = std::any_cast<std::shared_ptr<FunctionObject>>(&value);
+    if (function == nullptr || (*function)->arity() != arity)
+    {
+        throw std::runtime_error(std::string(builtin) + "() expects a function of " +
+                                 std::to_string(arity) + (arity == 1 ? " parameter" : " parameters"));
+    }
+    return *function;
+}
+
+static std::any builtinParMap(Interpreter &inter, std::span<const std::any> args)
+{
+    std::vector<std::any> elements = arrayArgument("par_map", args[0])->snapshot();
+    auto function = functionArgument("par_map", args[1], 1);
+
+    // Cada pedaço escreve só nas suas posições: a ordem sai de graça
+    std::vector<std::any> results(elements.size());
+    inter.parallelChunks(elements.size(), Interpreter::parallelChunk,
+                         [&](Interpreter &worker, size_t begin, size_t end)
+                         {
+                             for (size_t i = begin; i < end; i++)
+                             {
+                                 results[i] = function->call(&worker, {elements[i]});
+                             }
+                         });
+    return makePooled<ArrayObject>(std::move(results));
+}
+
+static std::any builtinParFilter(Interpreter &inter, std::span<const std::any> args)
+{
+    std::vector<std::any> elements = arrayArgument("par_filter", args[0])->snapshot();
+    auto function = functionArgument("par_filter", args[1], 1);
+
+    std::vector<std::vector<std::any>> kept((elements.size() + Interpreter::parallelChunk - 1) / Interpreter::parallelChunk);
+    inter.parallelChunks(elements.size(), Interpreter::parallelChunk,
+                         [&](Interpreter &worker, size_t begin, size_t end)
+                         {
+                             auto &out = kept[begin / Interpreter::parallelChunk];
+                             for (size_t i = begin; i < end; i++)
+                             {
+                                 if (worker.isTruthy(function->call(&worker, {elements[i]})))
+                                 {
+                                     out.push_back(elements[i]);
+                                 }
+                             }
+                         });
+
+    std::vector<std::any> results;
+    for (auto &part : kept)
+    {
+        results.insert(results.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+    }
+    return makePooled<ArrayObject>(std::move(results));
+}
+
+// f precisa ser associativa: cada pedaço é reduzido a partir do seu primeiro
+// elemento e os parciais são combinados em ordem, a partir de init
+static std::any builtinParReduce(Interpreter &inter, std::span<const std::any> args)
+{
+    std::vector<std::any> elements = arrayArgument("par_reduce", args[0])->snapshot();
+    auto function = functionArgument("par_reduce", args[1], 2);
+
+    std::vector<std::any> partials((elements.size() + Interpreter::parallelChunk - 1) / Interpreter::parallelChunk);
+    inter.parallelChunks(elements.size(), Interpreter::parallelChunk,
+                         [&](Interpreter &worker, size_t begin, size_t end)
+                         {
+                             std::any accumulator = elements[begin];
+                             for (size_t i = begin + 1; i < end; i++)
+                             {
+                                 accumulator = function->call(&worker, {accumulator, elements[i]});
+                             }
+                             partials[begin / Interpreter::parallelChunk] = std::move(accumulator);
+                         });
+
+    std::any result = args[2];
+    for (auto &partial : partials)
+    {
+        result = function->call(&inter, {result, partial});
+    }
+    return result;
+}
+
+static std::any builtinSleepAsync(Interpreter &, std::span<const std::any> args)
+{
+    auto milliseconds = std::any_cast<double>(&args[0]);
+    if (milliseconds == nullptr)
+    {
+        throw std::runtime_error("sleep_async() expects milliseconds");
+    }
+    return EventLoop::current().sleep(*milliseconds);
+}
+
+static std::any builtinReadFileAsync(Interpreter &inter, std::span<const std::any> args)
+{
+    std::string path = pathArgument("read_file_async", args[0]);
+    inter.fileSinks().flush();
+    return EventLoop::current().readFile(path);
+}
+
+static std::any builtinExecAsync(Interpreter &inter, std::span<const std::any> args)
+{
+    auto command = std::any_cast<String>(&args[0]);
+    if (command == nullptr)
+    {
+        throw std::runtime_error("exec_async() expects a command string");
+    }
+    // O processo herda o stdout e os arquivos: a saída pendente do script
+    // (que pode não ser o std::cout) vem antes
+    inter.output().flush();
+    inter.fileSinks().flush();
+    return EventLoop::current().runProcess(command->str());
+}
+
+static std::any builtinGcCollect(Interpreter &inter, std::span<const std::any>)
+{
+    return static_cast<double>(inter.collectGarbage());
+}
+
+static std::any builtinInclude(Interpreter &inter, std::span<const std::any> args)
+{
+    auto filename = std::any_cast<String>(&args[0]);
+    if (filename == nullptr)
+    {
+        throw std::runtime_error("include() expects a string filename");
+    }
+    return inter.executeFile(filename->str());
+}
+
+namespace
+{
+    struct Registry
+    {
+        std::vector<Builtin> builtins;
+        std::unordered_map<std::string, int> ids;
+
+        Registry()
+        {
+            define("input", 1, builtinInput);
+            define("to_string", 1, builtinToString);
+            define("to_number", 1, builtinToNumber);
+            define("len", 1, builtinLen);
+            define("push", 2, builtinPush);
+            define("pop", 1, builtinPop);
+            define("slice", 3, builtinSlice);
+            define("map", 0, builtinMap);
+            define("get", 2, builtinGet);
+            define("set", 0, 3, builtinSet);
+            define("has", 2, builtinHas);
+            define("remove", 2, builtinRemove);
+            define("keys", 1, builtinKeys);
+            define("union", 2, builtinUnion);
+            define("intersect", 2, builtinIntersect);
+            define("difference", 2, builtinDifference);
+            define("include", 1, builtinInclude);
+            define("gc_collect", 0, builtinGcCollect);
+            define("float64_array", 1, builtinFloat64Array);
+            define("sum", 1, builtinSum);
+            define("min", 1, builtinMin);
+            define("max", 1, builtinMax);
+            define("dot", 2, builtinDot);
+            define("add", 2, builtinAdd);
+            define("mul", 2, builtinMul);
+            define("scale", 2, builtinScale);
+            define("cumsum", 1, builtinCumsum);
+            define("greater", 2, builtinGreater);
+            define("less", 2, builtinLess);
+            define("equal", 2, builtinEqual);
+            define("join", 1, builtinJoin);
+            define("par_map", 2, builtinParMap);
+            define("par_filter", 2, builtinParFilter);
+            define("par_reduce", 3, builtinParReduce);
+            define("channel", 1, builtinChannel);
+            define("send", 2, builtinSend);
+            define("recv", 1, builtinRecv);
+            define("close", 1, builtinClose);
+            define("sleep_async", 1, builtinSleepAsync);
+            define("read_file_async", 1, builtinReadFileAsync);
+            define("exec_async", 1, builtinExecAsync);
+            define("open_read", 1, builtinOpenRead);
+            define("read_line", 1, builtinReadLine);
+            define("lines", 1, builtinLines);
+            define("print_to", 2, Builtin::unlimited, builtinPrintTo);
+            define("write_file", 2, builtinWriteFile);
+        }
+
+        int define(const std::string &name, size_t arity, NativeFunction function)
+        {
+            return define(name, arity, arity, function);
+        }
+
+        int define(const std::string &name, size_t minArity, size_t maxArity, NativeFunction function)
+        {
+            auto found = ids.find(name);
+            if (found != ids.end())
+            {
+                builtins[found->second] = {name, minArity, maxArity, function};
+                return found->second;
+            }
+            builtins.push_back({name, minArity, maxArity, function});
+            return ids[name] = static_cast<int>(builtins.size() - 1);
+        }
+    };
+
+    Registry &registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+}
+
+int Builtins::add(const std::string &name, size_t arity, NativeFunction function)
+{
+    return registry().define(name, arity, function);
+}
+
+int Builtins::add(const std::string &name, size_t minArity, size_t maxArity, NativeFunction function)
+{
+    return registry().define(name, minArity, maxArity, function);
+}
+
+void Builtins::load(const std::string &path)
+{
+    void *handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr)
+    {
+        throw std::runtime_error("Cannot load extension: " + std::string(dlerror()));
+    }
+
+    auto entry = reinterpret_cast<void (*)()>(dlsym(handle, "monny_register"));
+    if (entry == nullptr)
+    {
+        dlclose(handle);
+        throw std::runtime_error("Extension has no monny_register(): " + path);
+    }
+
+    // O handle fica aberto: as funções registradas apontam para dentro dele
+    entry();
+}
+
+int Builtins::lookup(const std::string &name)
+{
+    auto &ids = registry().ids;
+    auto found = ids.find(name);
+    return found == ids.end() ? -1 : found->second;
+}
+
+const Builtin &Builtins::get(int id)
+{
+    return registry().builtins[id];
+}
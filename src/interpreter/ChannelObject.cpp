@@ -0,0 +1,167 @@
+#include <interpreter/ChannelObject.hpp>
+#include <interpreter/Heap.hpp>
+#include <runtime/ThreadPool.hpp>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+ChannelObject::ChannelObject(size_t capacity)
+    : capacity(capacity), cellCount(std::max<size_t>(capacity, 2)), cells(new Cell[cellCount])
+{
+    for (size_t i = 0; i < cellCount; i++)
+    {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool ChannelObject::trySend(std::any &value)
+{
+    size_t position = sendPosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell &cell = cells[position % cellCount];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0)
+        {
+            // Canal de capacidade 1 tem uma célula a mais que a capacidade
+            if (capacity < cellCount && position - recvPosition.load(std::memory_order_acquire) >= capacity)
+            {
+                return false;
+            }
+            // Célula livre nesta volta: tenta reservar a posição
+            if (sendPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                cell.value = std::move(value);
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Ainda ocupada pela volta anterior: canal cheio
+            return false;
+        }
+        else
+        {
+            position = sendPosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ChannelObject::tryRecv(std::any &value)
+{
+    size_t position = recvPosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell &cell = cells[position % cellCount];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+        if (difference == 0)
+        {
+            if (recvPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                value = std::move(cell.value);
+                cell.value.reset();
+                // Libera a célula para a próxima volta do send
+                cell.sequence.store(position + cellCount, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Nada escrito nesta posição ainda: canal vazio
+            return false;
+        }
+        else
+        {
+            position = recvPosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void ChannelObject::send(std::any value)
+{
+    unsigned attempt = 0;
+    for (;;)
+    {
+        if (closed.load(std::memory_order_acquire))
+        {
+            throw std::runtime_error("send() on closed channel");
+        }
+        if (trySend(value))
+        {
+            wakeSleepers();
+            return;
+        }
+        pause(attempt);
+    }
+}
+
+std::any ChannelObject::recv()
+{
+    std::any value;
+    unsigned attempt = 0;
+    for (;;)
+    {
+        if (tryRecv(value))
+        {
+            wakeSleepers();
+            return value;
+        }
+        if (closed.load(std::memory_order_acquire))
+        {
+            // Um send anterior ao close pode ter chegado depois do tryRecv
+            if (tryRecv(value))
+            {
+                wakeSleepers();
+                return value;
+            }
+            return nullptr;
+        }
+        pause(attempt);
+    }
+}
+
+void ChannelObject::close()
+{
+    closed.store(true, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    changed.notify_all();
+}
+
+void ChannelObject::pause(unsigned &attempt)
+{
+    // Espera curta girando, depois dorme até alguém mexer no canal. Não
+    // ajuda o pool como o join: a task rodada aqui ficaria empilhada sobre
+    // esta e poderia esperar justamente por ela. Em vez disso o pool ganha
+    // um worker se todos estiverem bloqueados e houver trabalho na fila.
+    if (attempt++ < 64)
+    {
+        std::this_thread::yield();
+        return;
+    }
+
+    ThreadPool &pool = ThreadPool::shared();
+    pool.beginBlocking();
+    sleepers++;
+    {
+        Heap::Parked parked;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        changed.wait_for(lock, std::chrono::microseconds(200));
+    }
+    sleepers--;
+    pool.endBlocking();
+}
+
+void ChannelObject::wakeSleepers()
+{
+    if (sleepers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        changed.notify_all();
+    }
+}
@@ -0,0 +1,264 @@
+#include <interpreter/Format.hpp>
+#include <interpreter/ArrayObject.hpp>
+#include <interpreter/ChannelObject.hpp>
+#include <interpreter/FunctionObject.hpp>
+#include <interpreter/FutureObject.hpp>
+#include <interpreter/MapObject.hpp>
+#include <interpreter/ReaderObject.hpp>
+#include <interpreter/SetObject.hpp>
+#include <interpreter/String.hpp>
+#include <interpreter/StructObject.hpp>
+#include <interpreter/TaskObject.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // Maior inteiro que o double representa sem buracos
+    constexpr double exactIntegers = 9007199254740992.0;
+
+    struct StreamSink
+    {
+        std::ostream &stream;
+        void put(const char *data, size_t size) { stream.write(data, static_cast<std::streamsize>(size)); }
+    };
+
+    struct StringSink
+    {
+        std::string &text;
+        void put(const char *data, size_t size) { text.append(data, size); }
+    };
+
+    template <typename Sink>
+    void put(Sink &sink, const char *literal)
+    {
+        sink.put(literal, std::char_traits<char>::length(literal));
+    }
+
+    template <typename Sink>
+    void put(Sink &sink, std::string_view text)
+    {
+        sink.put(text.data(), text.size());
+    }
+
+    // 'open' guarda os arrays, maps e structs sendo escritos: um que contém
+    // a si mesmo sai como [...], {...} ou Nome{...} em vez de recursão sem fim
+    template <typename Sink>
+    void writeValue(Sink &sink, const std::any &value, bool nested, std::vector<const void *> &open)
+    {
+        const std::type_info &type = value.type();
+        if (type == typeid(double))
+        {
+            char buffer[Format::numberCapacity];
+            sink.put(buffer, Format::number(buffer, std::any_cast<double>(value)));
+        }
+        else if (type == typeid(String))
+        {
+            std::string_view text = std::any_cast<String>(&value)->view();
+            if (nested)
+            {
+                put(sink, "\"");
+                put(sink, text);
+                put(sink, "\"");
+            }
+            else
+            {
+                put(sink, text);
+            }
+        }
+        else if (type == typeid(bool))
+        {
+            put(sink, std::any_cast<bool>(value) ? "true" : "false");
+        }
+        else if (type == typeid(nullptr))
+        {
+            put(sink, "nil");
+        }
+        else if (type == typeid(std::shared_ptr<ArrayObject>))
+        {
+            const ArrayObject *array = std::any_cast<std::shared_ptr<ArrayObject>>(&value)->get();
+            if (std::find(open.begin(), open.end(), array) != open.end())
+            {
+                put(sink, "[...]");
+                return;
+            }
+
+            put(sink, "[");
+            bool first = true;
+            bool numeric = array->forEachNumber([&](double number)
+            {
+                if (!first)
+                {
+                    put(sink, ", ");
+                }
+                first = false;
+                char buffer[Format::numberCapacity];
+                sink.put(buffer, Format::number(buffer, number));
+            });
+            if (numeric)
+            {
+                put(sink, "]");
+                return;
+            }
+
+            open.push_back(array);
+            array->forEach([&](const std::any &element)
+            {
+                if (!first)
+                {
+                    put(sink, ", ");
+                }
+                first = false;
+                writeValue(sink, element, true, open);
+            });
+            put(sink, "]");
+            open.pop_back();
+        }
+        else if (type == typeid(std::shared_ptr<MapObject>))
+        {
+            const MapObject *map = std::any_cast<std::shared_ptr<MapObject>>(&value)->get();
+            if (std::find(open.begin(), open.end(), map) != open.end())
+            {
+                put(sink, "{...}");
+                return;
+            }
+
+            open.push_back(map);
+            put(sink, "{");
+            bool first = true;
+            map->forEach([&](const std::any &key, const std::any &element)
+            {
+                if (!first)
+                {
+                    put(sink, ", ");
+                }
+                first = false;
+                writeValue(sink, key, true, open);
+                put(sink, ": ");
+                writeValue(sink, element, true, open);
+            });
+            put(sink, "}");
+            open.pop_back();
+        }
+        else if (type == typeid(std::shared_ptr<SetObject>))
+        {
+            // Elementos são só números, strings e booleanos: sem ciclos
+            const SetObject *set = std::any_cast<std::shared_ptr<SetObject>>(&value)->get();
+            if (set->size() == 0)
+            {
+                put(sink, "set()");
+                return;
+            }
+            put(sink, "{");
+            bool first = true;
+            set->forEach([&](const std::any &element)
+            {
+                if (!first)
+                {
+                    put(sink, ", ");
+                }
+                first = false;
+                writeValue(sink, element, true, open);
+            });
+            put(sink, "}");
+        }
+        else if (type == typeid(std::shared_ptr<StructObject>))
+        {
+            const StructObject *object = std::any_cast<std::shared_ptr<StructObject>>(&value)->get();
+            const Shape &shape = object->shape();
+            put(sink, shape.name);
+            if (std::find(open.begin(), open.end(), object) != open.end())
+            {
+                put(sink, "{...}");
+                return;
+            }
+
+            open.push_back(object);
+            put(sink, "{");
+            std::vector<std::any> fields = object->values();
+            for (size_t i = 0; i < fields.size(); i++)
+            {
+                if (i > 0)
+                {
+                    put(sink, ", ");
+                }
+                put(sink, shape.fields[i]);
+                put(sink, ": ");
+                writeValue(sink, fields[i], true, open);
+            }
+            put(sink, "}");
+            open.pop_back();
+        }
+        else if (type == typeid(std::shared_ptr<const Shape>))
+        {
+            put(sink, "<struct ");
+            put(sink, (*std::any_cast<std::shared_ptr<const Shape>>(&value))->name);
+            put(sink, ">");
+        }
+        else if (type == typeid(std::shared_ptr<FunctionObject>))
+        {
+            put(sink, "<function>");
+        }
+        else if (type == typeid(std::shared_ptr<TaskObject>))
+        {
+            put(sink, "<task>");
+        }
+        else if (type == typeid(std::shared_ptr<ChannelObject>))
+        {
+            put(sink, "<channel>");
+        }
+        else if (type == typeid(std::shared_ptr<FutureObject>))
+        {
+            put(sink, "<future>");
+        }
+        else if (type == typeid(std::shared_ptr<ReaderObject>))
+        {
+            put(sink, "<reader ");
+            put(sink, (*std::any_cast<std::shared_ptr<ReaderObject>>(&value))->path);
+            put(sink, ">");
+        }
+        else
+        {
+            put(sink, "unknown");
+        }
+    }
+}
+
+size_t Format::number(char *buffer, double value)
+{
+    char *end = buffer + numberCapacity;
+
+    if (value >= -exactIntegers && value <= exactIntegers && value == std::trunc(value))
+    {
+        // Caso mais comum (contadores, índices): conversão inteira
+        if (value == 0 && std::signbit(value))
+        {
+            buffer[0] = '-';
+            buffer[1] = '0';
+            return 2;
+        }
+        return static_cast<size_t>(std::to_chars(buffer, end, static_cast<long long>(value)).ptr - buffer);
+    }
+    if (std::abs(value) < 1e21 && value == std::trunc(value))
+    {
+        return static_cast<size_t>(std::to_chars(buffer, end, value, std::chars_format::fixed).ptr - buffer);
+    }
+    return static_cast<size_t>(std::to_chars(buffer, end, value).ptr - buffer);
+}
+
+void Format::write(std::ostream &stream, const std::any &value)
+{
+    StreamSink sink{stream};
+    std::vector<const void *> open;
+    writeValue(sink, value, false, open);
+}
+
+void Format::append(std::string &text, const std::any &value)
+{
+    StringSink sink{text};
+    std::vector<const void *> open;
+    writeValue(sink, value, false, open);
+}
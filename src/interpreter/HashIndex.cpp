@@ -0,0 +1,98 @@
+#include <interpreter/HashIndex.hpp>
+#include <interpreter/String.hpp>
+#include <cmath>
+
+namespace
+{
+    // Espalha os bits: a posição vem dos bits altos, o byte de controle dos baixos
+    size_t mix(uint64_t hash)
+    {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return static_cast<size_t>(hash);
+    }
+}
+
+void HashIndex::insert(uint32_t entry, size_t hash)
+{
+    size_t groups = control.size() / groupWidth;
+    size_t group = (hash >> 7) & (groups - 1);
+    for (size_t step = 1;; step++)
+    {
+        uint64_t free = matchFree(loadGroup(&control[group * groupWidth]));
+        if (free != 0)
+        {
+            size_t position = group * groupWidth + std::countr_zero(free) / 8;
+            if (control[position] == emptyControl)
+            {
+                used++;
+            }
+            control[position] = hash & 0x7f;
+            slots[position] = entry;
+            return;
+        }
+        group = (group + step) & (groups - 1);
+    }
+}
+
+void HashIndex::reset(size_t count)
+{
+    size_t capacity = groupWidth;
+    while (capacity * 7 < count * 16)
+    {
+        capacity *= 2;
+    }
+    control.assign(capacity, emptyControl);
+    slots.assign(capacity, 0);
+    used = 0;
+}
+
+size_t HashIndex::hashNumber(double number)
+{
+    // -0 e 0 são a mesma chave
+    return mix(std::bit_cast<uint64_t>(number == 0 ? 0.0 : number));
+}
+
+bool HashIndex::hashKey(const std::any &key, size_t &hash)
+{
+    const std::type_info &type = key.type();
+    if (type == typeid(String))
+    {
+        hash = mix(std::any_cast<String>(&key)->hash());
+        return true;
+    }
+    if (type == typeid(double))
+    {
+        double number = *std::any_cast<double>(&key);
+        if (std::isnan(number))
+        {
+            return false;
+        }
+        hash = hashNumber(number);
+        return true;
+    }
+    if (type == typeid(bool))
+    {
+        hash = mix(*std::any_cast<bool>(&key) ? 2 : 1);
+        return true;
+    }
+    return false;
+}
+
+bool HashIndex::sameKey(const std::any &a, const std::any &b)
+{
+    if (a.type() != b.type())
+    {
+        return false;
+    }
+    if (a.type() == typeid(String))
+    {
+        return *std::any_cast<String>(&a) == *std::any_cast<String>(&b);
+    }
+    if (a.type() == typeid(double))
+    {
+        return *std::any_cast<double>(&a) == *std::any_cast<double>(&b);
+    }
+    return *std::any_cast<bool>(&a) == *std::any_cast<bool>(&b);
+}
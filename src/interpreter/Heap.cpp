@@ -0,0 +1,378 @@
+#include <interpreter/Heap.hpp>
+#include <interpreter/ArrayObject.hpp>
+#include <interpreter/FunctionObject.hpp>
+#include <interpreter/MapObject.hpp>
+#include <interpreter/StructObject.hpp>
+#include <chrono>
+#include <unordered_map>
+
+namespace
+{
+    thread_local Heap *currentHeap = nullptr;
+    // Heap da task que a thread está rodando (TaskScope), fora de um Parked
+    thread_local Heap *activeHeap = nullptr;
+
+    // Quanto o dono espera as tasks chegarem a um safepoint
+    constexpr std::chrono::milliseconds stopTimeout{5};
+
+    constexpr uint8_t youngGeneration = 0;
+    constexpr uint8_t oldGeneration = 1;
+
+    // Estado durante a coleta
+    constexpr uint8_t idle = 0;
+    constexpr uint8_t candidate = 1;
+    constexpr uint8_t reachable = 2;
+}
+
+Collectable::Collectable()
+{
+    if (Heap *heap = Heap::current())
+    {
+        heap->link(this);
+    }
+}
+
+Collectable::~Collectable()
+{
+    untrack();
+}
+
+void Collectable::untrack() noexcept
+{
+    if (heap != nullptr)
+    {
+        heap->unlink(this);
+    }
+}
+
+Collectable *Collectable::of(const std::any &value)
+{
+    const std::type_info &type = value.type();
+    if (type == typeid(std::shared_ptr<ArrayObject>))
+    {
+        return std::any_cast<std::shared_ptr<ArrayObject>>(&value)->get();
+    }
+    if (type == typeid(std::shared_ptr<MapObject>))
+    {
+        return std::any_cast<std::shared_ptr<MapObject>>(&value)->get();
+    }
+    if (type == typeid(std::shared_ptr<StructObject>))
+    {
+        return std::any_cast<std::shared_ptr<StructObject>>(&value)->get();
+    }
+    if (type == typeid(std::shared_ptr<FunctionObject>))
+    {
+        return std::any_cast<std::shared_ptr<FunctionObject>>(&value)->get();
+    }
+    return nullptr;
+}
+
+Heap::~Heap()
+{
+    auto lock = guard();
+    for (HeapLink *list : {&young, &old})
+    {
+        while (list->next != list)
+        {
+            auto object = static_cast<Collectable *>(list->next);
+            list->next = object->next;
+            object->heap = nullptr;
+            object->prev = object->next = nullptr;
+        }
+    }
+}
+
+Heap *Heap::current()
+{
+    return currentHeap;
+}
+
+Heap::Scope::Scope(Heap *heap) : previous(currentHeap)
+{
+    currentHeap = heap;
+}
+
+Heap::Scope::~Scope()
+{
+    currentHeap = previous;
+}
+
+Heap::TaskScope::TaskScope(Heap *heap) : heap(heap), previous(activeHeap)
+{
+    heap->enter();
+    activeHeap = heap;
+}
+
+Heap::TaskScope::~TaskScope()
+{
+    heap->leave();
+    activeHeap = previous;
+}
+
+Heap::Parked::Parked() : heap(activeHeap)
+{
+    if (heap != nullptr)
+    {
+        heap->leave();
+        activeHeap = nullptr;
+    }
+}
+
+Heap::Parked::~Parked()
+{
+    if (heap != nullptr)
+    {
+        heap->enter();
+        activeHeap = heap;
+    }
+}
+
+void Heap::enter()
+{
+    std::unique_lock<std::mutex> lock(stopMutex);
+    stopChanged.wait(lock, [this]() { return !stopping; });
+    running++;
+}
+
+void Heap::leave()
+{
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        running--;
+    }
+    stopChanged.notify_all();
+}
+
+void Heap::park()
+{
+    leave();
+    enter();
+}
+
+bool Heap::stopTasks()
+{
+    std::unique_lock<std::mutex> lock(stopMutex);
+    stopping = true;
+    if (stopChanged.wait_for(lock, stopTimeout, [this]() { return running == 0; }))
+    {
+        return true;
+    }
+    stopping = false;
+    lock.unlock();
+    stopChanged.notify_all();
+    return false;
+}
+
+void Heap::resumeTasks()
+{
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = false;
+    }
+    stopChanged.notify_all();
+}
+
+void Heap::link(Collectable *object)
+{
+    auto lock = guard();
+    object->heap = this;
+    object->generation = youngGeneration;
+    object->prev = young.prev;
+    object->next = &young;
+    young.prev->next = object;
+    young.prev = object;
+    bump(youngCount, 1);
+}
+
+void Heap::unlink(Collectable *object)
+{
+    auto lock = guard();
+    object->prev->next = object->next;
+    object->next->prev = object->prev;
+    object->heap = nullptr;
+    bump(object->generation == youngGeneration ? youngCount : oldCount, -1);
+}
+
+void Heap::promote()
+{
+    if (young.next == &young)
+    {
+        return;
+    }
+    for (HeapLink *link = young.next; link != &young; link = link->next)
+    {
+        static_cast<Collectable *>(link)->generation = oldGeneration;
+    }
+
+    // A lista jovem inteira entra no começo da velha
+    HeapLink *first = young.next;
+    HeapLink *last = young.prev;
+    first->prev = &old;
+    last->next = old.next;
+    old.next->prev = last;
+    old.next = first;
+    young.next = young.prev = &young;
+
+    bump(oldCount, static_cast<long>(youngCount.load(std::memory_order_relaxed)));
+    youngCount.store(0, std::memory_order_relaxed);
+}
+
+void Heap::collect()
+{
+    if (!collectGenerations(false))
+    {
+        return;
+    }
+    size_t threshold = oldAfterFull + oldAfterFull * limits.growth / 100 + limits.young;
+    if (oldCount.load(std::memory_order_relaxed) > threshold)
+    {
+        collectGenerations(true);
+    }
+}
+
+void Heap::collectAll()
+{
+    collectGenerations(true);
+}
+
+bool Heap::collectGenerations(bool full)
+{
+    // Sem spawn nem par_* até aqui, não há o que parar
+    bool stopped = shared.load(std::memory_order_acquire);
+    if (stopped && !stopTasks())
+    {
+        deferred.store(youngCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return false;
+    }
+    deferred.store(0, std::memory_order_relaxed);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::any> dead;
+    size_t freed = 0;
+    {
+        auto lock = guard();
+        if (full)
+        {
+            promote();
+        }
+        HeapLink &list = full ? old : young;
+
+        std::vector<Collectable *> candidates;
+        for (HeapLink *link = list.next; link != &list; link = link->next)
+        {
+            auto object = static_cast<Collectable *>(link);
+            // 0: fora de um shared_ptr, ou sendo destruído em outra thread
+            // (esperando este lock); as referências dele contam como de fora
+            object->refs = object->weak_from_this().use_count();
+            if (object->refs > 0)
+            {
+                object->state = candidate;
+                candidates.push_back(object);
+            }
+        }
+
+        // Armazenamento dividido: quantos objetos o dividem e quantos deles
+        // são candidatos
+        std::unordered_map<const void *, std::pair<size_t, size_t>> sharedOwners;
+        size_t sharers = 0;
+        for (Collectable *object : candidates)
+        {
+            if (const void *owner = object->sharedReferences(sharers))
+            {
+                auto &entry = sharedOwners[owner];
+                entry.first = sharers;
+                entry.second++;
+            }
+        }
+
+        std::vector<Collectable *> edges;
+        for (Collectable *object : candidates)
+        {
+            if (const void *owner = object->sharedReferences(sharers))
+            {
+                // Segurado também de fora dos candidatos, ou já descontado
+                auto &entry = sharedOwners[owner];
+                if (entry.second != entry.first)
+                {
+                    continue;
+                }
+                entry.second = 0;
+            }
+            edges.clear();
+            object->references(edges);
+            for (Collectable *target : edges)
+            {
+                if (target->state == candidate)
+                {
+                    target->refs--;
+                }
+            }
+        }
+
+        // Raízes: referências que sobraram vêm de fora dos candidatos
+        std::vector<Collectable *> pending;
+        for (Collectable *object : candidates)
+        {
+            if (object->refs > 0)
+            {
+                object->state = reachable;
+                pending.push_back(object);
+            }
+        }
+        while (!pending.empty())
+        {
+            Collectable *object = pending.back();
+            pending.pop_back();
+            edges.clear();
+            object->references(edges);
+            for (Collectable *target : edges)
+            {
+                if (target->state == candidate)
+                {
+                    target->state = reachable;
+                    pending.push_back(target);
+                }
+            }
+        }
+
+        for (Collectable *object : candidates)
+        {
+            if (object->state == candidate)
+            {
+                object->clearReferences(dead);
+                freed++;
+            }
+            object->state = idle;
+        }
+        if (!full)
+        {
+            promote();
+        }
+    }
+    // Destrói o lixo fora do lock: os destrutores saem das listas
+    dead.clear();
+    if (stopped)
+    {
+        resumeTasks();
+    }
+
+    if (full)
+    {
+        totals.full++;
+        oldAfterFull = oldCount.load(std::memory_order_relaxed);
+    }
+    else
+    {
+        totals.minor++;
+    }
+    totals.freed += freed;
+    totals.millis += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+Heap::Stats Heap::stats() const
+{
+    Stats result = totals;
+    result.tracked = youngCount.load(std::memory_order_relaxed) + oldCount.load(std::memory_order_relaxed);
+    return result;
+}
@@ -1,73 +1,241 @@
 #include <interpreter/Inter.hpp>
 #include <interpreter/ArrayObject.hpp>
+#include <interpreter/MapObject.hpp>
+#include <interpreter/SetObject.hpp>
+#include <interpreter/StructObject.hpp>
+#include <interpreter/TaskObject.hpp>
+#include <interpreter/ChannelObject.hpp>
+#include <interpreter/FutureObject.hpp>
+#include <interpreter/ReaderObject.hpp>
+#include <interpreter/Format.hpp>
+#include <interpreter/String.hpp>
+#include <runtime/EventLoop.hpp>
+#include <runtime/Output.hpp>
+#include <runtime/ThreadPool.hpp>
+#include <utils/HeapStack.hpp>
+#include <utils/Pool.hpp>
 #include <tokenizer/Scanner.hpp>
 #include <parser/Parser.hpp>
-#include <utils/Systems.hpp>
 #include <sstream>
 #include <iostream>
 #include <limits>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 
 // ========== INTERFACE PÚBLICA ==========
 
-void Interpreter::interpret(const std::vector<std::shared_ptr<Statements::Stmt>> &statements)
+Interpreter::Interpreter() : heap(std::make_shared<Heap>()), files(std::make_shared<FileSinks>())
 {
+    Heap::Scope scope(heap.get());
+    environment = makePooled<Environment>();
+}
+
+Interpreter::~Interpreter()
+{
+    if (!ownsHeap)
+    {
+        return;
+    }
+    waitForTasks();
+    // Sem o environment e os caches, o que sobra no heap são ciclos
+    environment.reset();
+    clearCaches();
+    result.reset();
+    returnValue.reset();
+    heap->collectAll();
+}
+
+void Interpreter::setMaxDepth(size_t limit)
+{
+    maxDepth = limit;
+}
+
+void Interpreter::setStreams(std::istream &input, std::ostream &output, std::ostream &errors)
+{
+    in = &input;
+    out = &output;
+    err = &errors;
+}
+
+void Interpreter::setHeapLimits(const Heap::Limits &limits)
+{
+    heap->setLimits(limits);
+}
+
+Heap::Stats Interpreter::heapStats() const
+{
+    return heap->stats();
+}
+
+size_t Interpreter::collectGarbage()
+{
+    // Uma task esperaria por ela mesma parar
+    if (!ownsHeap)
+    {
+        throw std::runtime_error("gc_collect() can only run in the main program, not in tasks or async functions");
+    }
+    size_t before = heap->stats().freed;
+    heap->collectAll();
+    return heap->stats().freed - before;
+}
+
+Interpreter::Interpreter(const TaskContext &context)
+    : heap(context.heap), ownsHeap(false), environment(context.environment), in(context.in), out(context.out), err(context.err),
+      outputLock(context.outputLock), tasks(context.tasks), files(context.files), maxDepth(context.maxDepth)
+{
+    // pthread_getattr_np é caro na thread principal: uma vez por thread
+    static thread_local const uintptr_t stackBottom = HeapStack::bottom();
+    setStackBottom(stackBottom);
+}
+
+void Interpreter::reset()
+{
+    Heap::Scope scope(heap.get());
+    environment = makePooled<Environment>();
+    // O environment novo recomeça a época, então os caches não valem mais
+    clearCaches();
+    depth = 0;
+    returning = false;
+    returnValue.reset();
+    // Ciclos do pedido anterior não passam para o próximo
+    heap->collectAll();
+}
+
+void Interpreter::setStackBottom(uintptr_t bottom)
+{
+    stackLimit = bottom + HeapStack::margin;
+}
+
+bool Interpreter::interpret(const std::vector<std::shared_ptr<Statements::Stmt>> &statements)
+{
+    Heap::Scope scope(heap.get());
     try
     {
         for (const auto &statement : statements)
         {
             execute(statement);
+            if (returning)
+            {
+                // return no topo do script encerra a execução
+                returning = false;
+                returnValue.reset();
+                break;
+            }
         }
     }
     catch (const std::runtime_error &error)
     {
-        std::cerr << "Runtime error: " << error.what() << std::endl;
+        returning = false;
+        // A saída já impressa vem antes da mensagem de erro
+        out->flush();
+        *err << "Runtime error: " << error.what() << std::endl;
+        return false;
     }
+    return true;
 }
 
-void Interpreter::execute(std::shared_ptr<Statements::Stmt> stmt)
+bool Interpreter::run(const Program &program)
 {
-    if (auto printStmt = std::dynamic_pointer_cast<Statements::Print>(stmt))
+    Heap::Scope scope(heap.get());
+    bool ok = interpret(program.statements);
+
+    // Funções async e I/O que ninguém aguardou ainda terminam antes de sair,
+    // assim como tasks sem join: o dono dos streams pode sumir depois daqui
+    if (EventLoop *loop = EventLoop::existing())
+    {
+        loop->drain();
+    }
+    waitForTasks();
+
+    // Um run não deixa arquivos abertos para o próximo (--batch, --serve)
+    try
+    {
+        files->close();
+    }
+    catch (const std::runtime_error &error)
+    {
+        out->flush();
+        *err << "Runtime error: " << error.what() << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+std::any Interpreter::call(const std::string &name, const std::vector<std::any> &arguments)
+{
+    Heap::Scope scope(heap.get());
+    std::any value = environment->get(name);
+    auto function = std::any_cast<std::shared_ptr<FunctionObject>>(&value);
+    if (function == nullptr)
+    {
+        throw std::runtime_error("'" + name + "' is not a function");
+    }
+
+    // Conveniência do host: std::string vira String do Monny
+    std::vector<std::any> values(arguments);
+    for (auto &argument : values)
+    {
+        if (auto text = std::any_cast<std::string>(&argument))
+        {
+            argument = String(*text);
+        }
+    }
+    return (*function)->call(this, values);
+}
+
+void Interpreter::execute(const std::shared_ptr<Statements::Stmt> &stmt)
+{
+    if (auto printStmt = dynamic_cast<Statements::Print *>(stmt.get()))
     {
         executePrint(printStmt);
     }
-    else if (auto exprStmt = std::dynamic_pointer_cast<Statements::Expression>(stmt))
+    else if (auto exprStmt = dynamic_cast<Statements::Expression *>(stmt.get()))
     {
         executeExpression(exprStmt);
     }
-    else if (auto ifStmt = std::dynamic_pointer_cast<Statements::IF>(stmt))
+    else if (auto ifStmt = dynamic_cast<Statements::IF *>(stmt.get()))
     {
         executeIf(ifStmt);
     }
-    else if (auto varStmt = std::dynamic_pointer_cast<Statements::Var>(stmt))
+    else if (auto varStmt = dynamic_cast<Statements::Var *>(stmt.get()))
     {
         executeVar(varStmt);
     }
-    else if (auto blockStmt = std::dynamic_pointer_cast<Statements::Block>(stmt))
+    else if (auto blockStmt = dynamic_cast<Statements::Block *>(stmt.get()))
     {
         executeBlock(blockStmt);
     }
-    else if (auto whileStmt = std::dynamic_pointer_cast<Statements::While>(stmt))
+    else if (auto whileStmt = dynamic_cast<Statements::While *>(stmt.get()))
     {
         executeWhile(whileStmt);
     }
-    else if (auto clearStmt = std::dynamic_pointer_cast<Statements::Clear>(stmt))
+    else if (auto clearStmt = dynamic_cast<Statements::Clear *>(stmt.get()))
     {
         executeClear(clearStmt);
     }
-    else if (auto funcDef = std::dynamic_pointer_cast<Statements::FunctionDef>(stmt))
+    else if (dynamic_cast<Statements::FunctionDef *>(stmt.get()))
+    {
+        // O FunctionObject guarda a declaração, então precisa do shared_ptr
+        executeFunctionDef(std::static_pointer_cast<Statements::FunctionDef>(stmt));
+    }
+    else if (auto parallelFor = dynamic_cast<Statements::ParallelFor *>(stmt.get()))
     {
-        executeFunctionDef(funcDef);
+        executeParallelFor(parallelFor);
     }
-    else if (auto constStmt = std::dynamic_pointer_cast<Statements::Const>(stmt))
+    else if (auto constStmt = dynamic_cast<Statements::Const *>(stmt.get()))
     {
         executeConst(constStmt);
     }
+    else if (auto structDef = dynamic_cast<Statements::StructDef *>(stmt.get()))
+    {
+        executeStructDef(structDef);
+    }
 }
 
 // ========== IMPLEMENTAÇÃO DOS STATEMENTS ==========
 
-void Interpreter::executeConst(std::shared_ptr<Statements::Const> stmt)
+void Interpreter::executeConst(Statements::Const *stmt)
 {
     // CONST sempre tem initializer (obrigatório pelo parser)
     std::any value = evaluate(stmt->initializer);
@@ -76,43 +244,199 @@ void Interpreter::executeConst(std::shared_ptr<Statements::Const> stmt)
     environment->define(stmt->name.lexeme, value, true);
 }
 
-void Interpreter::executeFunctionDef(std::shared_ptr<Statements::FunctionDef> stmt)
+void Interpreter::executeParallelFor(Statements::ParallelFor *stmt)
+{
+    std::any startValue = evaluate(stmt->start);
+    std::any endValue = evaluate(stmt->end);
+    if (startValue.type() != typeid(double) || endValue.type() != typeid(double))
+    {
+        throw std::runtime_error("parallel for bounds must be numbers");
+    }
+    double start = std::any_cast<double>(startValue);
+    double end = std::any_cast<double>(endValue);
+    // Testado antes da conversão: NaN, infinito ou acima de size_t seriam UB
+    if (!std::isfinite(start) || !std::isfinite(end))
+    {
+        throw std::runtime_error("parallel for bounds must be finite numbers");
+    }
+    double span = std::floor(end - start) + (stmt->inclusive || end - start != std::floor(end - start) ? 1 : 0);
+    if (span > static_cast<double>(maxParallelIterations))
+    {
+        throw std::runtime_error("parallel for range is too large (at most " +
+                                 std::to_string(maxParallelIterations) + " iterations)");
+    }
+    size_t count = span > 0 ? static_cast<size_t>(span) : 0;
+
+    // Cada pedaço começa as reduções do elemento neutro
+    const auto &reductions = stmt->reductions;
+    std::vector<double> identities;
+    for (const auto &reduction : reductions)
+    {
+        if (environment->get(reduction.name.lexeme).type() != typeid(double))
+        {
+            throw std::runtime_error("Reduction variable '" + reduction.name.lexeme + "' must be a number");
+        }
+        const std::string &oper = reduction.oper.lexeme;
+        identities.push_back(oper == "+" ? 0.0
+                             : oper == "*" ? 1.0
+                             : oper == "min" ? std::numeric_limits<double>::infinity()
+                                             : -std::numeric_limits<double>::infinity());
+    }
+
+    auto combine = [](const Token &oper, double a, double b)
+    {
+        if (oper.lexeme == "+")
+            return a + b;
+        if (oper.lexeme == "*")
+            return a * b;
+        if (oper.lexeme == "min")
+            return std::min(a, b);
+        return std::max(a, b);
+    };
+
+    size_t chunks = (count + parallelChunk - 1) / parallelChunk;
+    std::vector<std::vector<double>> partials(chunks);
+    // O parser só vê o corpo; funções chamadas nele são barradas aqui
+    uint64_t barrier = Environment::WriteBarrier::open();
+    parallelChunks(count, parallelChunk, [&](Interpreter &worker, size_t begin, size_t finish)
+    {
+        Environment::WriteBarrier guard(barrier);
+        // Environment do pedaço: contador e cópias privadas das reduções
+        auto previousEnv = worker.environment;
+        worker.environment = makePooled<Environment>(previousEnv);
+        try
+        {
+            worker.environment->define(stmt->variable.lexeme, start + static_cast<double>(begin));
+            for (size_t r = 0; r < reductions.size(); r++)
+            {
+                worker.environment->define(reductions[r].name.lexeme, identities[r]);
+            }
+            for (size_t i = begin; i < finish; i++)
+            {
+                worker.environment->assign(stmt->variable.lexeme, start + static_cast<double>(i));
+                worker.executeBlock(stmt->body.get());
+            }
+
+            auto &partial = partials[begin / parallelChunk];
+            for (const auto &reduction : reductions)
+            {
+                std::any value = worker.environment->get(reduction.name.lexeme);
+                if (value.type() != typeid(double))
+                {
+                    throw std::runtime_error("Reduction variable '" + reduction.name.lexeme + "' must be a number");
+                }
+                partial.push_back(std::any_cast<double>(value));
+            }
+        }
+        catch (...)
+        {
+            worker.environment = previousEnv;
+            throw;
+        }
+        worker.environment = previousEnv;
+    });
+
+    // Junta os parciais na ordem dos pedaços, a partir do valor atual
+    for (size_t r = 0; r < reductions.size(); r++)
+    {
+        double value = std::any_cast<double>(environment->get(reductions[r].name.lexeme));
+        for (const auto &partial : partials)
+        {
+            value = combine(reductions[r].oper, value, partial[r]);
+        }
+        environment->assign(reductions[r].name.lexeme, value);
+    }
+}
+
+void Interpreter::executeFunctionDef(const std::shared_ptr<Statements::FunctionDef> &stmt)
 {
     // Armazena a definição da função diretamente no environment
-    FunctionObject funcData{stmt, environment};
+    auto funcData = makePooled<FunctionObject>(stmt, environment);
     environment->define(stmt->name.lexeme, funcData, false);
 }
 
-void Interpreter::executeClear(std::shared_ptr<Statements::Clear> stmt)
+void Interpreter::executeStructDef(Statements::StructDef *stmt)
 {
-    System::clear();
+    std::vector<std::string> fields;
+    fields.reserve(stmt->fields.size());
+    for (const auto &field : stmt->fields)
+    {
+        fields.push_back(field.lexeme);
+    }
+    std::shared_ptr<const Shape> shape = std::make_shared<Shape>(stmt->name.lexeme, std::move(fields));
+    environment->define(stmt->name.lexeme, shape);
 }
 
-void Interpreter::executePrint(std::shared_ptr<Statements::Print> stmt)
+void Interpreter::executeClear(Statements::Clear *stmt)
 {
-    for (size_t i = 0; i < stmt->expressions.size(); i++)
+    // Sequência ANSI no stream do interpretador, em ordem com os prints
+    // (e no cliente, em --batch e --serve), em vez de um clear no terminal
+    static constexpr std::string_view sequence = "\x1b[H\x1b[2J\x1b[3J";
+    if (outputLock != nullptr)
     {
-        std::any value = evaluate(stmt->expressions[i]);
+        std::lock_guard<std::mutex> lock(*outputLock);
+        out->write(sequence.data(), sequence.size());
+        return;
+    }
+    out->write(sequence.data(), sequence.size());
+}
 
-        // Se for string, processa caracteres de escape
-        if (value.type() == typeid(std::string))
+void Interpreter::executePrint(Statements::Print *stmt)
+{
+    if (outputLock != nullptr)
+    {
+        // Com tasks no ar, avalia tudo antes e escreve a linha sob o lock
+        std::vector<std::any> values;
+        values.reserve(stmt->expressions.size());
+        for (const auto &expression : stmt->expressions)
         {
-            std::string str = std::any_cast<std::string>(value);
-            std::cout << processEscapeSequences(str);
+            values.push_back(evaluate(expression));
         }
-        else
+        std::lock_guard<std::mutex> lock(*outputLock);
+        for (const auto &value : values)
         {
-            std::cout << stringify(value);
+            writeValue(*out, value);
         }
+        return;
+    }
+
+    for (const auto &expression : stmt->expressions)
+    {
+        writeValue(*out, evaluate(expression));
     }
 }
 
-void Interpreter::executeExpression(std::shared_ptr<Statements::Expression> stmt)
+void Interpreter::executeExpression(Statements::Expression *stmt)
 {
+    // `s = s + x;` com o valor descartado: a string cresce no lugar em vez
+    // de ser copiada inteira a cada volta do laço
+    auto assign = dynamic_cast<Assign *>(stmt->expression.get());
+    if (assign != nullptr && !assign->appended.empty())
+    {
+        std::vector<std::any> pieces;
+        pieces.reserve(assign->appended.size());
+        for (const auto &piece : assign->appended)
+        {
+            pieces.push_back(evaluate(piece));
+        }
+        if (environment->append(assign->name.lexeme, pieces))
+        {
+            return;
+        }
+
+        std::any value = environment->get(assign->name.lexeme);
+        for (auto &piece : pieces)
+        {
+            value = add(std::move(value), std::move(piece));
+        }
+        environment->assign(assign->name.lexeme, std::move(value));
+        return;
+    }
+
     evaluate(stmt->expression);
 }
 
-void Interpreter::executeIf(std::shared_ptr<Statements::IF> stmt)
+void Interpreter::executeIf(Statements::IF *stmt)
 {
     if (isTruthy(evaluate(stmt->condition)))
     {
@@ -124,7 +448,7 @@ void Interpreter::executeIf(std::shared_ptr<Statements::IF> stmt)
     }
 }
 
-void Interpreter::executeVar(std::shared_ptr<Statements::Var> stmt)
+void Interpreter::executeVar(Statements::Var *stmt)
 {
     std::any value = nullptr;
     if (stmt->initializer != nullptr)
@@ -134,15 +458,20 @@ void Interpreter::executeVar(std::shared_ptr<Statements::Var> stmt)
     environment->define(stmt->name.lexeme, value);
 }
 
-void Interpreter::executeWhile(std::shared_ptr<Statements::While> stmt)
+void Interpreter::executeWhile(Statements::While *stmt)
 {
     while (isTruthy(evaluate(stmt->condition)))
     {
         execute(stmt->body);
+        if (returning)
+        {
+            break;
+        }
+        collectIfDue();
     }
 }
 
-void Interpreter::executeBlock(std::shared_ptr<Statements::Block> stmt)
+void Interpreter::executeBlock(Statements::Block *stmt)
 {
     environment->enter_scope();
     try
@@ -150,83 +479,108 @@ void Interpreter::executeBlock(std::shared_ptr<Statements::Block> stmt)
         for (const auto &statement : stmt->statements)
         {
             execute(statement);
+            if (returning)
+            {
+                // O valor fica em returnValue para o callUserFunction
+                break;
+            }
         }
     }
-    catch (const ReturnException &)
+    catch (...)
     {
-        // Re-lança a exceção de return para que seja capturada pelo callUserFunction
+        // Erros param o script (ou chegam ao join da task); o escopo sai antes
         environment->exit_scope();
         throw;
     }
-    catch (const std::exception &e)
-    {
-        environment->exit_scope();
-    }
 
     environment->exit_scope();
 }
 
 // ========== IMPLEMENTAÇÃO DAS EXPRESSÕES ==========
 
-std::any Interpreter::evaluate(std::shared_ptr<Expr> expr)
+std::any Interpreter::evaluate(const std::shared_ptr<Expr> &expr)
 {
-    if (auto binary = std::dynamic_pointer_cast<Binary>(expr))
+    if (auto binary = dynamic_cast<Binary *>(expr.get()))
     {
         return evaluateBinary(binary);
     }
-    else if (auto literal = std::dynamic_pointer_cast<Literal>(expr))
+    else if (auto literal = dynamic_cast<Literal *>(expr.get()))
     {
         return evaluateLiteral(literal);
     }
-    else if (auto grouping = std::dynamic_pointer_cast<Grouping>(expr))
+    else if (auto grouping = dynamic_cast<Grouping *>(expr.get()))
     {
         return evaluateGrouping(grouping);
     }
-    else if (auto variable = std::dynamic_pointer_cast<Variable>(expr))
+    else if (auto variable = dynamic_cast<Variable *>(expr.get()))
     {
         return evaluateVariable(variable);
     }
-    else if (auto assign = std::dynamic_pointer_cast<Assign>(expr))
+    else if (auto assign = dynamic_cast<Assign *>(expr.get()))
     {
         return evaluateAssign(assign);
     }
-    else if (auto funcCall = std::dynamic_pointer_cast<FunctionCall>(expr))
+    else if (auto funcCall = dynamic_cast<FunctionCall *>(expr.get()))
     {
         return evaluateFunctionCall(funcCall);
     }
-    else if (auto incre = std::dynamic_pointer_cast<Increment>(expr))
+    else if (auto incre = dynamic_cast<Increment *>(expr.get()))
     {
         return evaluateIncrement(incre);
     }
-    else if (auto unary = std::dynamic_pointer_cast<Unary>(expr))
+    else if (auto unary = dynamic_cast<Unary *>(expr.get()))
     {
         return evaluateUnary(unary); // ← NOVO
     }
-    else if (auto logical = std::dynamic_pointer_cast<Logical>(expr))
+    else if (auto logical = dynamic_cast<Logical *>(expr.get()))
     {
         return evaluateLogical(logical); // ← NOVO
     }
-    else if (auto returnExpr = std::dynamic_pointer_cast<Return>(expr))
+    else if (auto returnExpr = dynamic_cast<Return *>(expr.get()))
     {
         return evaluateReturn(returnExpr);
     }
-    else if (auto arrayLit = std::dynamic_pointer_cast<ArrayLiteral>(expr))
+    else if (auto arrayLit = dynamic_cast<ArrayLiteral *>(expr.get()))
     {
         return evaluateArrayLiteral(arrayLit);
     }
-    else if (auto arrayAccess = std::dynamic_pointer_cast<ArrayAccess>(expr))
+    else if (auto mapLit = dynamic_cast<MapLiteral *>(expr.get()))
+    {
+        return evaluateMapLiteral(mapLit);
+    }
+    else if (auto arrayAccess = dynamic_cast<ArrayAccess *>(expr.get()))
     {
         return evaluateArrayAccess(arrayAccess);
     }
-    else if (auto arrayAssign = std::dynamic_pointer_cast<ArrayAssign>(expr))
+    else if (auto getField = dynamic_cast<GetField *>(expr.get()))
+    {
+        return evaluateGetField(getField);
+    }
+    else if (auto arraySlice = dynamic_cast<ArraySlice *>(expr.get()))
+    {
+        return evaluateArraySlice(arraySlice);
+    }
+    else if (auto arrayAssign = dynamic_cast<ArrayAssign *>(expr.get()))
     {
         return evaluateArrayAssign(arrayAssign);
     }
+    else if (auto setField = dynamic_cast<SetField *>(expr.get()))
+    {
+        return evaluateSetField(setField);
+    }
+    else if (auto spawn = dynamic_cast<Spawn *>(expr.get()))
+    {
+        return evaluateSpawn(spawn);
+    }
+    else if (auto await = dynamic_cast<Await *>(expr.get()))
+    {
+        return evaluateAwait(await);
+    }
 
     throw std::runtime_error("Unknown expression type");
 }
 
-std::any Interpreter::evaluateReturn(std::shared_ptr<Return> expr)
+std::any Interpreter::evaluateReturn(Return *expr)
 {
     std::any value = nullptr;
     if (expr->value != nullptr)
@@ -234,11 +588,13 @@ std::any Interpreter::evaluateReturn(std::shared_ptr<Return> expr)
         value = evaluate(expr->value);
     }
 
-    // CORREÇÃO: Lança a exceção em vez de retornar
-    throw ReturnException(value);
+    // Marca o return; blocos e loops param até o callUserFunction
+    returnValue = value;
+    returning = true;
+    return value;
 }
 
-std::any Interpreter::evaluateLogical(std::shared_ptr<Logical> expr)
+std::any Interpreter::evaluateLogical(Logical *expr)
 {
     std::any left = evaluate(expr->left);
 
@@ -257,7 +613,7 @@ std::any Interpreter::evaluateLogical(std::shared_ptr<Logical> expr)
     return evaluate(expr->right);
 }
 
-std::any Interpreter::evaluateUnary(std::shared_ptr<Unary> expr)
+std::any Interpreter::evaluateUnary(Unary *expr)
 {
     std::any right = evaluate(expr->right);
 
@@ -275,17 +631,28 @@ std::any Interpreter::evaluateUnary(std::shared_ptr<Unary> expr)
     }
 }
 
-std::any Interpreter::evaluateArrayLiteral(std::shared_ptr<ArrayLiteral> expr)
+std::any Interpreter::evaluateArrayLiteral(ArrayLiteral *expr)
 {
     std::vector<std::any> elements;
     for (const auto &element : expr->elements)
     {
         elements.push_back(evaluate(element));
     }
-    return std::make_shared<ArrayObject>(elements);
+    return makePooled<ArrayObject>(std::move(elements));
 }
 
-std::any Interpreter::evaluateArrayAccess(std::shared_ptr<ArrayAccess> expr)
+std::any Interpreter::evaluateMapLiteral(MapLiteral *expr)
+{
+    auto map = makePooled<MapObject>();
+    for (size_t i = 0; i < expr->keys.size(); i++)
+    {
+        std::any key = evaluate(expr->keys[i]);
+        map->set(key, evaluate(expr->values[i]));
+    }
+    return map;
+}
+
+std::any Interpreter::evaluateArrayAccess(ArrayAccess *expr)
 {
     std::any arrayAny = evaluate(expr->array);
     std::any indexAny = evaluate(expr->index);
@@ -294,20 +661,42 @@ std::any Interpreter::evaluateArrayAccess(std::shared_ptr<ArrayAccess> expr)
     {
         if (indexAny.type() == typeid(double))
         {
-            int index = static_cast<int>(std::any_cast<double>(indexAny));
-
-            if (index >= 0 && index < (*array)->elements.size())
-            {
-                return (*array)->elements[index];
-            }
-            throw std::runtime_error("Array index out of bounds");
+            return (*array)->get(static_cast<long>(std::any_cast<double>(indexAny)));
         }
         throw std::runtime_error("Array index must be a number");
     }
     throw std::runtime_error("Expected array");
 }
 
-std::any Interpreter::evaluateArrayAssign(std::shared_ptr<ArrayAssign> expr)
+std::any Interpreter::evaluateArraySlice(ArraySlice *expr)
+{
+    std::any arrayAny = evaluate(expr->array);
+    auto array = std::any_cast<std::shared_ptr<ArrayObject>>(&arrayAny);
+    if (array == nullptr)
+    {
+        throw std::runtime_error("Expected array");
+    }
+
+    // Limite ausente: começo ou fim do array
+    auto bound = [&](const std::shared_ptr<Expr> &limit, long missing)
+    {
+        if (!limit)
+        {
+            return missing;
+        }
+        std::any value = evaluate(limit);
+        if (value.type() != typeid(double))
+        {
+            throw std::runtime_error("Slice bounds must be numbers");
+        }
+        return static_cast<long>(std::any_cast<double>(value));
+    };
+    long start = bound(expr->start, 0);
+    long end = bound(expr->end, static_cast<long>((*array)->size()));
+    return (*array)->slice(start, end);
+}
+
+std::any Interpreter::evaluateArrayAssign(ArrayAssign *expr)
 {
     std::any arrayAny = evaluate(expr->array);
     std::any indexAny = evaluate(expr->index);
@@ -317,23 +706,89 @@ std::any Interpreter::evaluateArrayAssign(std::shared_ptr<ArrayAssign> expr)
     {
         if (indexAny.type() == typeid(double))
         {
-            int index = static_cast<int>(std::any_cast<double>(indexAny));
-
-            if (index >= 0 && index < (*array)->elements.size())
-            {
-                (*array)->elements[index] = value;
-                return value;
-            }
-            throw std::runtime_error("Array index out of bounds");
+            (*array)->set(static_cast<long>(std::any_cast<double>(indexAny)), value);
+            return value;
         }
         throw std::runtime_error("Array index must be a number");
     }
     throw std::runtime_error("Expected array");
 }
 
-std::any Interpreter::evaluateIncrement(std::shared_ptr<Increment> expr)
+StructObject &Interpreter::structOperand(const std::any &value)
 {
-    auto varExpr = std::dynamic_pointer_cast<Variable>(expr->operand);
+    auto object = std::any_cast<std::shared_ptr<StructObject>>(&value);
+    if (object == nullptr)
+    {
+        throw std::runtime_error("Only struct instances have fields");
+    }
+    return **object;
+}
+
+Interpreter::SiteCaches &Interpreter::switchCaches(const std::shared_ptr<SiteTable> &sites)
+{
+    auto found = siteCaches.find(sites->id);
+    if (found == siteCaches.end())
+    {
+        // EVALs e include() antigos não seguram caches para sempre
+        std::erase_if(siteCaches, [](const auto &entry) { return entry.second.table.expired(); });
+        found = siteCaches.emplace(sites->id, SiteCaches{sites, {}, {}}).first;
+    }
+    lastCaches = &found->second;
+    lastSites = sites->id;
+    return *lastCaches;
+}
+
+void Interpreter::clearCaches()
+{
+    siteCaches.clear();
+    lastCaches = nullptr;
+    lastSites = 0;
+}
+
+size_t Interpreter::fieldSlot(const std::shared_ptr<const Shape> &shape, const std::shared_ptr<SiteTable> &sites,
+                              size_t site, const Token &name)
+{
+    SiteCaches &caches = cachesFor(sites);
+    if (site >= caches.fields.size())
+    {
+        caches.fields.resize(sites->fields);
+    }
+
+    // Acerto: uma comparação de ponteiro, sem olhar o nome
+    FieldCache &cache = caches.fields[site];
+    if (cache.shape.get() == shape.get())
+    {
+        return cache.slot;
+    }
+
+    size_t slot = shape->slot(name.lexeme);
+    if (slot == Shape::npos)
+    {
+        throw std::runtime_error("Undefined field '" + name.lexeme + "' on " + shape->name);
+    }
+    cache = {shape, slot};
+    return slot;
+}
+
+std::any Interpreter::evaluateGetField(GetField *expr)
+{
+    std::any objectAny = evaluate(expr->object);
+    StructObject &object = structOperand(objectAny);
+    return object.get(fieldSlot(object.sharedShape(), expr->sites, expr->site, expr->name));
+}
+
+std::any Interpreter::evaluateSetField(SetField *expr)
+{
+    std::any objectAny = evaluate(expr->object);
+    std::any value = evaluate(expr->value);
+    StructObject &object = structOperand(objectAny);
+    object.set(fieldSlot(object.sharedShape(), expr->sites, expr->site, expr->name), value);
+    return value;
+}
+
+std::any Interpreter::evaluateIncrement(Increment *expr)
+{
+    auto varExpr = dynamic_cast<Variable *>(expr->operand.get());
     if (!varExpr)
     {
         throw std::runtime_error("Increment/decrement can only be applied to variables");
@@ -363,7 +818,22 @@ std::any Interpreter::evaluateIncrement(std::shared_ptr<Increment> expr)
     }
 }
 
-std::any Interpreter::evaluateBinary(std::shared_ptr<Binary> expr)
+std::any Interpreter::add(std::any left, std::any right)
+{
+    if (left.type() == typeid(double) && right.type() == typeid(double))
+    {
+        return std::any_cast<double>(left) + std::any_cast<double>(right);
+    }
+    auto leftText = std::any_cast<String>(&left);
+    auto rightText = std::any_cast<String>(&right);
+    if (leftText != nullptr && rightText != nullptr)
+    {
+        return String::concat(leftText->view(), rightText->view());
+    }
+    throw std::runtime_error("Operands must be two numbers or two strings.");
+}
+
+std::any Interpreter::evaluateBinary(Binary *expr)
 {
     std::any left = evaluate(expr->left);
     std::any right = evaluate(expr->right);
@@ -397,15 +867,7 @@ std::any Interpreter::evaluateBinary(std::shared_ptr<Binary> expr)
         return std::any_cast<double>(left) - std::any_cast<double>(right);
 
     case TokenType::PLUS:
-        if (left.type() == typeid(double) && right.type() == typeid(double))
-        {
-            return std::any_cast<double>(left) + std::any_cast<double>(right);
-        }
-        if (left.type() == typeid(std::string) && right.type() == typeid(std::string))
-        {
-            return std::any_cast<std::string>(left) + std::any_cast<std::string>(right);
-        }
-        throw std::runtime_error("Operands must be two numbers or two strings.");
+        return add(std::move(left), std::move(right));
 
     case TokenType::SLASH:
         checkNumberOperands(expr->oper, left, right);
@@ -419,206 +881,410 @@ std::any Interpreter::evaluateBinary(std::shared_ptr<Binary> expr)
     return nullptr;
 }
 
-std::any Interpreter::evaluateLiteral(std::shared_ptr<Literal> expr)
+std::any Interpreter::evaluateLiteral(Literal *expr)
 {
     return expr->value;
 }
 
-std::any Interpreter::evaluateGrouping(std::shared_ptr<Grouping> expr)
+std::any Interpreter::evaluateGrouping(Grouping *expr)
 {
     return evaluate(expr->expression);
 }
 
-std::any Interpreter::evaluateVariable(std::shared_ptr<Variable> expr)
+std::any Interpreter::evaluateVariable(Variable *expr)
 {
     return environment->get(expr->name.lexeme);
 }
 
-std::any Interpreter::evaluateAssign(std::shared_ptr<Assign> expr)
+std::any Interpreter::evaluateAssign(Assign *expr)
 {
     std::any value = evaluate(expr->value);
     environment->assign(expr->name.lexeme, value);
     return value;
 }
 
-std::any Interpreter::evaluateFunctionCall(std::shared_ptr<FunctionCall> expr)
+std::any Interpreter::evaluateFunctionCall(FunctionCall *expr)
 {
-    // Para funções built-in, precisamos extrair o nome do callee
-    std::string functionName;
+    // Builtins já foram resolvidos pelo parser
+    if (expr->builtin >= 0 && builtinVisible(expr))
+    {
+        return callBuiltin(Builtins::get(expr->builtin), expr->arguments);
+    }
 
-    // Se o callee for um Variable, extraímos o nome do token
-    if (auto var = std::dynamic_pointer_cast<Variable>(expr->callee))
+    CallCache callee = resolveCallee(expr);
+    if (callee.shape != nullptr)
     {
-        functionName = var->name.lexeme;
+        return construct(callee.shape, expr->arguments);
     }
-    else
+    auto funcDef = callee.function->declaration.get();
+
+    // Avalia argumentos
+    std::vector<std::any> arguments;
+    arguments.reserve(expr->arguments.size());
+    for (const auto &arg : expr->arguments)
     {
-        // Para outros tipos de callee, avaliamos e tentamos converter
-        std::any calleeValue = evaluate(expr->callee);
-        // Lógica para outros tipos de callee...
-        throw std::runtime_error("Complex function calls not yet supported");
+        arguments.push_back(evaluate(arg));
     }
 
-    // Agora usa functionName em vez de expr->name.lexeme
-    if (functionName == "input")
+    // Verifica número de parâmetros
+    if (arguments.size() != funcDef->params.size())
     {
-        std::string prompt;
-        if (expr->arguments.size() != 1)
-        {
-            throw std::runtime_error("input() expects exactly 1 argument");
-        }
+        throw std::runtime_error("Expected " +
+                                 std::to_string(funcDef->params.size()) +
+                                 " arguments but got " +
+                                 std::to_string(arguments.size()));
+    }
+
+    return callUserFunction(static_cast<Variable *>(expr->callee.get())->name.lexeme, arguments, funcDef);
+}
+
+std::any Interpreter::construct(const std::shared_ptr<const Shape> &shape,
+                               const std::vector<std::shared_ptr<Expr>> &arguments)
+{
+    if (arguments.size() != shape->fields.size())
+    {
+        throw std::runtime_error(shape->name + " expects " + std::to_string(shape->fields.size()) +
+                                 (shape->fields.size() == 1 ? " field" : " fields") +
+                                 " but got " + std::to_string(arguments.size()));
+    }
+
+    std::vector<std::any> values;
+    values.reserve(arguments.size());
+    for (const auto &arg : arguments)
+    {
+        values.push_back(evaluate(arg));
+    }
+    return makePooled<StructObject>(shape, std::move(values));
+}
 
-        std::any promptVal = evaluate(expr->arguments[0]);
-        prompt = stringify(promptVal);
+std::shared_ptr<FunctionObject> Interpreter::resolveFunction(FunctionCall *expr)
+{
+    CallCache callee = resolveCallee(expr);
+    if (callee.function == nullptr)
+    {
+        throw std::runtime_error("'" + callee.shape->name + "' is a struct, not a function");
+    }
+    return callee.function;
+}
 
-        std::cout << prompt;
+bool Interpreter::builtinVisible(FunctionCall *expr)
+{
+    SiteCaches &caches = cachesFor(expr->sites);
+    if (expr->site >= caches.calls.size())
+    {
+        caches.calls.resize(expr->sites->calls);
+    }
 
-        if (std::cin.peek() == '\n')
+    CallCache &cache = caches.calls[expr->site];
+    if (cache.epoch == environment->functionEpoch())
+    {
+        if (cache.builtin)
+        {
+            return true;
+        }
+        if (cache.function != nullptr || cache.shape != nullptr)
         {
-            std::cin.ignore();
+            return false;
         }
+    }
 
-        std::string input;
-        std::getline(std::cin, input);
+    // O parser só conhece as funções do próprio arquivo. Depois do watch,
+    // um binding novo com o nome muda a época e invalida o cache.
+    const std::string &name = static_cast<Variable *>(expr->callee.get())->name.lexeme;
+    environment->watch(name);
+    uint64_t epoch = environment->functionEpoch();
+    if (environment->has(name))
+    {
+        return false;
+    }
+    cache = {nullptr, nullptr, epoch, true};
+    return true;
+}
 
-        input.erase(0, input.find_first_not_of(" \t\n\r\f\v"));
-        input.erase(input.find_last_not_of(" \t\n\r\f\v") + 1);
+Interpreter::CallCache Interpreter::resolveCallee(FunctionCall *expr)
+{
+    // Para funções do usuário, precisamos extrair o nome do callee
+    auto var = dynamic_cast<Variable *>(expr->callee.get());
+    if (var == nullptr)
+    {
+        throw std::runtime_error("Complex function calls not yet supported");
+    }
+    const std::string &functionName = var->name.lexeme;
 
-        return input;
+    SiteCaches &caches = cachesFor(expr->sites);
+    if (expr->site >= caches.calls.size())
+    {
+        caches.calls.resize(expr->sites->calls);
     }
-    else if (functionName == "to_string")
+
+    CallCache &cache = caches.calls[expr->site];
+    if ((cache.function != nullptr || cache.shape != nullptr) && cache.epoch == environment->functionEpoch())
     {
-        if (expr->arguments.size() != 1)
-        {
-            throw std::runtime_error("to_string() expects exactly 1 argument");
-        }
-        return stringify(evaluate(expr->arguments[0]));
+        return cache;
+    }
+
+    std::any funcAny;
+    try
+    {
+        funcAny = environment->get(functionName);
     }
-    else if (functionName == "to_number")
+    catch (const std::runtime_error &e)
     {
-        if (expr->arguments.size() != 1)
-        {
-            throw std::runtime_error("to_number() expects exactly 1 argument");
-        }
-        auto value = evaluate(expr->arguments[0]);
-        if (value.type() == typeid(std::string))
+        // Se não encontrou a variável, cai no erro de função desconhecida
+    }
+
+    if (auto found = std::any_cast<std::shared_ptr<FunctionObject>>(&funcAny))
+    {
+        cache = {*found, nullptr, environment->functionEpoch()};
+        return cache;
+    }
+    if (auto shape = std::any_cast<std::shared_ptr<const Shape>>(&funcAny))
+    {
+        cache = {nullptr, *shape, environment->functionEpoch()};
+        return cache;
+    }
+    throw std::runtime_error("Unknown function: " + functionName);
+}
+
+std::any Interpreter::evaluateSpawn(Spawn *expr)
+{
+    FunctionCall *call = expr->call.get();
+    if (call->builtin >= 0 && builtinVisible(call))
+    {
+        throw std::runtime_error("spawn expects a user function, not builtin '" +
+                                 Builtins::get(call->builtin).name + "'");
+    }
+    std::shared_ptr<FunctionObject> function = resolveFunction(call);
+    size_t arity = function->declaration->params.size();
+
+    // Argumentos são avaliados por quem faz o spawn
+    std::vector<std::any> arguments;
+    arguments.reserve(call->arguments.size());
+    for (const auto &arg : call->arguments)
+    {
+        arguments.push_back(evaluate(arg));
+    }
+    if (arguments.size() != arity)
+    {
+        throw std::runtime_error("Expected " + std::to_string(arity) +
+                                 " arguments but got " +
+                                 std::to_string(arguments.size()));
+    }
+
+    auto task = std::make_shared<TaskObject>();
+    TaskContext context = shareWithTasks();
+    tasks->begin();
+    uint64_t barrier = Environment::WriteBarrier::current();
+    ThreadPool::shared().submit(
+        [task, function, arguments = std::move(arguments), context = std::move(context),
+         name = static_cast<Variable *>(call->callee.get())->name.lexeme, barrier]() mutable
         {
-            try
             {
-                return std::stod(std::any_cast<std::string>(value));
+                Environment::WriteBarrier guard(barrier);
+                Heap::Scope scope(context.heap.get());
+                Heap::TaskScope active(context.heap.get());
+                Interpreter worker(context);
+                try
+                {
+                    std::any result = worker.callUserFunction(name, arguments, function->declaration.get());
+                    // spawn de uma função async: o future é desta thread, então
+                    // espera aqui e o join recebe o valor
+                    if (auto future = std::any_cast<std::shared_ptr<FutureObject>>(&result))
+                    {
+                        result = EventLoop::current().await(*future);
+                    }
+                    task->complete(std::move(result));
+                }
+                catch (const std::exception &error)
+                {
+                    task->fail(error.what());
+                }
+                // Nada desta task continua segurado depois do end
+                arguments.clear();
+                function.reset();
+                context.environment.reset();
+                task.reset();
             }
-            catch (...)
-            {
-                throw std::runtime_error("Cannot convert string to number");
-            }
-        }
-        return value;
+            context.tasks->end();
+        });
+    return task;
+}
+
+std::any Interpreter::evaluateAwait(Await *expr)
+{
+    std::any value = evaluate(expr->value);
+    if (auto future = std::any_cast<std::shared_ptr<FutureObject>>(&value))
+    {
+        return EventLoop::current().await(*future);
     }
-    else if (functionName == "len")
+    if (auto task = std::any_cast<std::shared_ptr<TaskObject>>(&value))
     {
-        if (expr->arguments.size() != 1)
-        {
-            throw std::runtime_error("len() expects exactly 1 argument");
-        }
-        std::any arg = evaluate(expr->arguments[0]);
+        return (*task)->join();
+    }
+    // await de um valor comum devolve o próprio valor
+    return value;
+}
 
-        if (auto array = std::any_cast<std::shared_ptr<ArrayObject>>(&arg))
+std::any Interpreter::startAsync(const std::string &name,
+                                 const std::vector<std::any> &arguments,
+                                 Statements::FunctionDef *funcDef)
+{
+    EventLoop &loop = EventLoop::current();
+    auto future = std::make_shared<FutureObject>(&loop);
+
+    // A fibra é desta thread: herda o environment sem marcá-lo compartilhado
+    TaskContext context{environment, in, out, err, outputLock, maxDepth, heap, tasks, files};
+    // Sem Heap::Scope: a fibra roda sob o heap de quem gira o loop, que é
+    // o deste interpretador
+    loop.startFiber([future, context, name, arguments, funcDef](uintptr_t stackBottom)
+    {
+        Interpreter worker(context);
+        worker.setStackBottom(stackBottom);
+        try
         {
-            return static_cast<double>((*array)->elements.size());
+            future->complete(worker.runFunction(name, arguments, funcDef));
         }
-        if (arg.type() == typeid(std::string))
+        catch (const std::exception &error)
         {
-            return static_cast<double>(std::any_cast<std::string>(arg).length());
+            future->fail(error.what());
         }
-        throw std::runtime_error("len() expects array or string");
+    });
+    return future;
+}
+
+Interpreter::TaskContext Interpreter::shareWithTasks()
+{
+    // Daqui em diante o environment atual e qualquer array, map, set ou
+    // struct podem ser usados por outra thread
+    environment->markShared();
+    ArrayObject::concurrent = true;
+    MapObject::concurrent = true;
+    SetObject::concurrent = true;
+    StructObject::concurrent = true;
+    if (outputLock == nullptr)
+    {
+        outputLock = std::make_shared<std::mutex>();
     }
-    else if (functionName == "push")
+    if (tasks == nullptr)
     {
-        if (expr->arguments.size() != 2)
-        {
-            throw std::runtime_error("push() expects exactly 2 arguments");
-        }
-        std::any arrayAny = evaluate(expr->arguments[0]);
-        std::any value = evaluate(expr->arguments[1]);
+        tasks = std::make_shared<TaskGroup>();
+    }
+    heap->share();
+    return {environment, in, out, err, outputLock, maxDepth, heap, tasks, files};
+}
 
-        if (auto array = std::any_cast<std::shared_ptr<ArrayObject>>(&arrayAny))
+void Interpreter::waitForTasks()
+{
+    if (ownsHeap && tasks != nullptr)
+    {
+        tasks->wait();
+    }
+}
+
+void Interpreter::parallelChunks(size_t count, size_t chunk,
+                                 const std::function<void(Interpreter &, size_t, size_t)> &body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (count <= chunk)
+    {
+        // Um pedaço só: não vale acordar o pool
+        body(*this, 0, count);
+        return;
+    }
+
+    TaskContext context = shareWithTasks();
+    uint64_t barrier = Environment::WriteBarrier::current();
+    std::vector<std::shared_ptr<TaskObject>> tasks;
+    for (size_t begin = 0; begin < count; begin += chunk)
+    {
+        size_t end = std::min(count, begin + chunk);
+        auto task = std::make_shared<TaskObject>();
+        tasks.push_back(task);
+        // Os pedaços rodam sem heap: o que criam fica fora do rastreio.
+        // São temporários da chamada, e travar o heap a cada environment
+        // de função deixava o par_map 10% mais lento.
+        ThreadPool::shared().submit([task, &context, &body, begin, end, barrier]()
         {
-            (*array)->elements.push_back(value);
-            return value;
-        }
-        throw std::runtime_error("push() expects array as first argument");
+            Environment::WriteBarrier guard(barrier);
+            Heap::Scope scope(nullptr);
+            // Mas leem e escrevem objetos do heap: a coleta espera por eles
+            Heap::TaskScope active(context.heap.get());
+            Interpreter worker(context);
+            try
+            {
+                body(worker, begin, end);
+                task->complete(nullptr);
+            }
+            catch (const std::exception &error)
+            {
+                task->fail(error.what());
+            }
+        });
     }
-    else if (functionName == "pop")
+
+    // Espera todos antes de sair: os pedaços usam a pilha de quem chamou
+    std::string firstError;
+    for (const auto &task : tasks)
     {
-        if (expr->arguments.size() != 1)
+        try
         {
-            throw std::runtime_error("pop() expects exactly 1 argument");
+            task->join();
         }
-        std::any arrayAny = evaluate(expr->arguments[0]);
-
-        if (auto array = std::any_cast<std::shared_ptr<ArrayObject>>(&arrayAny))
+        catch (const std::exception &error)
         {
-            if ((*array)->elements.empty())
+            if (firstError.empty())
             {
-                throw std::runtime_error("Cannot pop from empty array");
+                firstError = error.what();
             }
-            auto last = (*array)->elements.back();
-            (*array)->elements.pop_back();
-            return last;
         }
-        throw std::runtime_error("pop() expects array");
     }
-    if (functionName == "include")
+    if (!firstError.empty())
     {
-        if (expr->arguments.size() != 1)
+        throw std::runtime_error(firstError);
+    }
+}
+
+std::any Interpreter::callBuiltin(const Builtin &builtin, const std::vector<std::shared_ptr<Expr>> &arguments)
+{
+    if (arguments.size() < builtin.arity || arguments.size() > builtin.maxArity)
+    {
+        if (builtin.maxArity == Builtin::unlimited)
         {
-            throw std::runtime_error("include() expects exactly 1 argument");
+            throw std::runtime_error(builtin.name + "() expects at least " + std::to_string(builtin.arity) +
+                                     (builtin.arity == 1 ? " argument" : " arguments"));
         }
-
-        std::any filenameAny = evaluate(expr->arguments[0]);
-        if (filenameAny.type() != typeid(std::string))
+        if (builtin.arity != builtin.maxArity)
         {
-            throw std::runtime_error("include() expects a string filename");
+            throw std::runtime_error(builtin.name + "() expects " + std::to_string(builtin.arity) +
+                                     " to " + std::to_string(builtin.maxArity) + " arguments");
         }
-
-        std::string filename = std::any_cast<std::string>(filenameAny);
-        return executeFile(filename);
+        throw std::runtime_error(builtin.name + "() expects exactly " +
+                                 std::to_string(builtin.arity) +
+                                 (builtin.arity == 1 ? " argument" : " arguments"));
     }
 
-    try
+    // Poucos argumentos ficam na pilha, sem alocar
+    constexpr size_t inlineArgs = 4;
+    if (arguments.size() <= inlineArgs)
     {
-        std::any funcAny = environment->get(functionName);
-
-        if (funcAny.type() == typeid(FunctionObject))
+        std::any values[inlineArgs];
+        for (size_t i = 0; i < arguments.size(); i++)
         {
-            FunctionObject funcData = std::any_cast<FunctionObject>(funcAny);
-            auto funcDef = funcData.declaration;
-
-            // Avalia argumentos
-            std::vector<std::any> arguments;
-            for (const auto &arg : expr->arguments)
-            {
-                arguments.push_back(evaluate(arg));
-            }
-
-            // Verifica número de parâmetros
-            if (arguments.size() != funcDef->params.size())
-            {
-                throw std::runtime_error("Expected " +
-                                         std::to_string(funcDef->params.size()) +
-                                         " arguments but got " +
-                                         std::to_string(arguments.size()));
-            }
-
-            return callUserFunction(functionName, arguments, funcDef);
+            values[i] = evaluate(arguments[i]);
         }
+        return builtin.function(*this, std::span<const std::any>(values, arguments.size()));
     }
-    catch (const std::runtime_error &e)
+
+    std::vector<std::any> values;
+    values.reserve(arguments.size());
+    for (const auto &arg : arguments)
     {
-        // Se não encontrou a variável, continua para ver se é built-in
+        values.push_back(evaluate(arg));
     }
-
-    throw std::runtime_error("Unknown function: " + functionName);
+    return builtin.function(*this, values);
 }
 
 // ========== FUNÇÕES AUXILIARES ==========
@@ -664,9 +1330,9 @@ bool Interpreter::isEqual(std::any a, std::any b)
     {
         return std::any_cast<double>(a) == std::any_cast<double>(b);
     }
-    if (a.type() == typeid(std::string))
+    if (a.type() == typeid(String))
     {
-        return std::any_cast<std::string>(a) == std::any_cast<std::string>(b);
+        return *std::any_cast<String>(&a) == *std::any_cast<String>(&b);
     }
 
     return false;
@@ -688,39 +1354,64 @@ void Interpreter::checkNumberOperands(const Token &oper, std::any left, std::any
 
 std::string Interpreter::stringify(std::any value)
 {
-    if (value.type() == typeid(nullptr))
-        return "nil";
-    if (value.type() == typeid(bool))
-        return std::any_cast<bool>(value) ? "true" : "false";
-    if (value.type() == typeid(double))
+    std::string text;
+    Format::append(text, value);
+    return text;
+}
+
+std::any FunctionObject::call(Interpreter *interpreter, const std::vector<std::any> &arguments)
+{
+    if (arguments.size() != declaration->params.size())
     {
-        std::string text = std::to_string(std::any_cast<double>(value));
-        text.erase(text.find_last_not_of('0') + 1, std::string::npos);
-        text.erase(text.find_last_not_of('.') + 1, std::string::npos);
-        return text;
+        throw std::runtime_error("Expected " +
+                                 std::to_string(declaration->params.size()) +
+                                 " arguments but got " +
+                                 std::to_string(arguments.size()));
     }
-    if (value.type() == typeid(std::string))
-        return std::any_cast<std::string>(value);
-    if (value.type() == typeid(FunctionObject))
-        return "<function>";
-    if (value.type() == typeid(std::shared_ptr<ArrayObject>))
+    return interpreter->callUserFunction(declaration->name.lexeme, arguments, declaration.get());
+}
+
+void FunctionObject::references(std::vector<Collectable *> &out) const
+{
+    if (closure != nullptr)
     {
-        auto array = std::any_cast<std::shared_ptr<ArrayObject>>(value);
-        return array->toString();
+        out.push_back(closure.get());
     }
+}
 
-    return "unknown";
+bool Interpreter::stackExhausted()
+{
+    char marker;
+    return reinterpret_cast<uintptr_t>(&marker) < stackLimit;
 }
 
 std::any Interpreter::callUserFunction(const std::string &name,
                                        const std::vector<std::any> &arguments,
-                                       std::shared_ptr<Statements::FunctionDef> funcDef)
+                                       Statements::FunctionDef *funcDef)
 {
+    if (funcDef->isAsync)
+    {
+        return startAsync(name, arguments, funcDef);
+    }
+    return runFunction(name, arguments, funcDef);
+}
+
+std::any Interpreter::runFunction(const std::string &name,
+                                  const std::vector<std::any> &arguments,
+                                  Statements::FunctionDef *funcDef)
+{
+    if ((maxDepth != 0 && depth >= maxDepth) || stackExhausted())
+    {
+        throw std::runtime_error("Maximum recursion depth exceeded in '" + name +
+                         "' (depth " + std::to_string(depth) + ")");
+    }
+    collectIfDue();
+
     // Salva environment atual
     auto previousEnv = environment;
 
     // Cria novo environment para a função (com parent para acessar funções built-in)
-    environment = std::make_shared<Environment>(previousEnv);
+    environment = makePooled<Environment>(previousEnv);
 
     // Define parâmetros
     for (size_t i = 0; i < funcDef->params.size(); i++)
@@ -730,21 +1421,28 @@ std::any Interpreter::callUserFunction(const std::string &name,
 
     // Executa o corpo da função
     std::any result = nullptr;
+    depth++;
     try
     {
-        execute(funcDef->body);
-    }
-    catch (const ReturnException &ret)
-    {
-        result = ret.value;
+        executeBlock(funcDef->body.get());
     }
     catch (...)
     {
+        depth--;
+        returning = false;
         environment = previousEnv;
         throw;
     }
 
+    if (returning)
+    {
+        result = std::move(returnValue);
+        returnValue.reset();
+        returning = false;
+    }
+
     // Restaura environment
+    depth--;
     environment = previousEnv;
     return result;
 }
@@ -774,28 +1472,48 @@ std::any Interpreter::executeFile(const std::string &filename)
     for (const auto &stmt : statements)
     {
         execute(stmt);
+        if (returning)
+        {
+            break;
+        }
     }
 
     return nullptr; // include não retorna valor
 }
 
-std::string Interpreter::processEscapeSequences(const std::string& str)
+void Interpreter::writeValue(std::ostream &stream, const std::any &value)
 {
-    std::string result;
-    for (size_t i = 0; i < str.length(); i++) {
-        if (str[i] == '\\' && i + 1 < str.length()) {
-            switch (str[i + 1]) {
-                case 'n': result += '\n'; break;
-                case 't': result += '\t'; break;
-                case 'r': result += '\r'; break;
-                case '\\': result += '\\'; break;
-                case '"': result += '"'; break;
-                default: result += str[i + 1]; break;
-            }
-            i++; // Pula o próximo caractere
-        } else {
-            result += str[i];
+    if (auto str = std::any_cast<String>(&value))
+    {
+        writeEscaped(stream, str->view());
+    }
+    else
+    {
+        Format::write(stream, value);
+    }
+}
+
+void Interpreter::writeEscaped(std::ostream &stream, std::string_view str)
+{
+    // Trechos sem '\\' vão inteiros para o buffer; só o escape é traduzido
+    const char *cursor = str.data();
+    const char *end = cursor + str.size();
+    while (cursor < end)
+    {
+        auto slash = static_cast<const char *>(std::memchr(cursor, '\\', static_cast<size_t>(end - cursor)));
+        if (slash == nullptr || slash + 1 == end)
+        {
+            stream.write(cursor, end - cursor);
+            return;
         }
+        stream.write(cursor, slash - cursor);
+        switch (slash[1])
+        {
+            case 'n': stream.put('\n'); break;
+            case 't': stream.put('\t'); break;
+            case 'r': stream.put('\r'); break;
+            default: stream.put(slash[1]); break;
+        }
+        cursor = slash + 2;
     }
-    return result;
 }
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include <interpreter/MapObject.hpp>
+#include <stdexcept>
+
+size_t MapObject::hashKey(const std::any &key)
+{
+    size_t hash;
+    if (!HashIndex::hashKey(key, hash))
+    {
+        if (key.type() == typeid(double))
+        {
+            throw std::runtime_error("Map keys cannot be NaN");
+        }
+        throw std::runtime_error("Map keys must be strings, numbers or booleans");
+    }
+    return hash;
+}
+
+size_t MapObject::find(const std::any &key, size_t hash) const
+{
+    return index.find(hash, [&](uint32_t entry)
+    {
+        return entries[entry].hash == hash && HashIndex::sameKey(entries[entry].key, key);
+    });
+}
+
+void MapObject::rebuild()
+{
+    if (live != entries.size())
+    {
+        std::erase_if(entries, [](const Entry &entry) { return !entry.key.has_value(); });
+    }
+    index.reset(live + 1);
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        index.insert(static_cast<uint32_t>(i), entries[i].hash);
+    }
+}
+
+size_t MapObject::size() const
+{
+    auto lock = guard();
+    return live;
+}
+
+bool MapObject::get(const std::any &key, std::any &value) const
+{
+    size_t hash = hashKey(key);
+    auto lock = guard();
+    size_t position = find(key, hash);
+    if (position == HashIndex::npos)
+    {
+        return false;
+    }
+    value = entries[index.entry(position)].value;
+    return true;
+}
+
+void MapObject::set(const std::any &key, std::any value)
+{
+    size_t hash = hashKey(key);
+    auto lock = guard();
+    size_t position = find(key, hash);
+    if (position != HashIndex::npos)
+    {
+        entries[index.entry(position)].value = std::move(value);
+        return;
+    }
+
+    if (index.full())
+    {
+        rebuild();
+    }
+    entries.push_back({key, std::move(value), hash});
+    live++;
+    index.insert(static_cast<uint32_t>(entries.size() - 1), hash);
+}
+
+bool MapObject::has(const std::any &key) const
+{
+    size_t hash = hashKey(key);
+    auto lock = guard();
+    return find(key, hash) != HashIndex::npos;
+}
+
+bool MapObject::remove(const std::any &key)
+{
+    size_t hash = hashKey(key);
+    auto lock = guard();
+    size_t position = find(key, hash);
+    if (position == HashIndex::npos)
+    {
+        return false;
+    }
+
+    index.erase(position);
+    Entry &entry = entries[index.entry(position)];
+    entry.key.reset();
+    entry.value.reset();
+    live--;
+    // Muitas removidas: compacta antes que dominem o vetor
+    if (entries.size() > 2 * live + 8)
+    {
+        rebuild();
+    }
+    return true;
+}
+
+std::vector<std::any> MapObject::keys() const
+{
+    auto lock = guard();
+    std::vector<std::any> result;
+    result.reserve(live);
+    for (const auto &entry : entries)
+    {
+        if (entry.key.has_value())
+        {
+            result.push_back(entry.key);
+        }
+    }
+    return result;
+}
+
+void MapObject::references(std::vector<Collectable *> &out) const
+{
+    // Chaves são strings, números ou booleanos: só os valores referenciam
+    for (const auto &entry : entries)
+    {
+        if (Collectable *object = Collectable::of(entry.value))
+        {
+            out.push_back(object);
+        }
+    }
+}
+
+void MapObject::clearReferences(std::vector<std::any> &dead)
+{
+    for (auto &entry : entries)
+    {
+        dead.push_back(std::move(entry.value));
+    }
+}
+
+std::vector<std::pair<std::any, std::any>> MapObject::snapshot() const
+{
+    auto lock = guard();
+    std::vector<std::pair<std::any, std::any>> result;
+    result.reserve(live);
+    for (const auto &entry : entries)
+    {
+        if (entry.key.has_value())
+        {
+            result.emplace_back(entry.key, entry.value);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,145 @@
+#include <interpreter/ReaderObject.hpp>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Tamanho dos blocos quando o arquivo não pode ser mapeado
+static constexpr size_t blockSize = 256 * 1024;
+
+ReaderObject::ReaderObject(const std::string &path) : path(path)
+{
+    fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        void *mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED)
+        {
+            // Leitura linear: o kernel pode ler à frente com folga
+            madvise(mapped, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            data = static_cast<const char *>(mapped);
+            size = static_cast<size_t>(info.st_size);
+        }
+    }
+}
+
+ReaderObject::~ReaderObject()
+{
+    release();
+}
+
+void ReaderObject::release()
+{
+    if (data != nullptr)
+    {
+        munmap(const_cast<char *>(data), size);
+        data = nullptr;
+        size = position = 0;
+    }
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+    buffer.clear();
+    buffer.shrink_to_fit();
+    bufferStart = bufferEnd = 0;
+    eof = true;
+}
+
+void ReaderObject::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    release();
+}
+
+bool ReaderObject::fill()
+{
+    // Move o resto não consumido para o começo e lê mais um bloco
+    if (bufferStart > 0)
+    {
+        std::memmove(buffer.data(), buffer.data() + bufferStart, bufferEnd - bufferStart);
+        bufferEnd -= bufferStart;
+        bufferStart = 0;
+    }
+    if (buffer.size() - bufferEnd < blockSize)
+    {
+        buffer.resize(bufferEnd + blockSize);
+    }
+
+    ssize_t count = read(fd, buffer.data() + bufferEnd, blockSize);
+    if (count <= 0)
+    {
+        eof = true;
+        return false;
+    }
+    bufferEnd += static_cast<size_t>(count);
+    return true;
+}
+
+static void assignLine(String &line, const char *begin, size_t length)
+{
+    if (length > 0 && begin[length - 1] == '\r')
+    {
+        length--;
+    }
+    // Sob o lock: close() de outra task não desmapeia no meio da cópia
+    line = String(std::string_view(begin, length));
+}
+
+bool ReaderObject::readLine(String &line)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (data != nullptr)
+    {
+        if (position >= size)
+        {
+            return false;
+        }
+        const char *begin = data + position;
+        size_t remaining = size - position;
+        auto newline = static_cast<const char *>(std::memchr(begin, '\n', remaining));
+        size_t length = newline != nullptr ? static_cast<size_t>(newline - begin) : remaining;
+        assignLine(line, begin, length);
+        position += newline != nullptr ? length + 1 : length;
+        return true;
+    }
+
+    size_t scanned = bufferStart;
+    for (;;)
+    {
+        // Buffer ainda vazio: data() pode ser nulo
+        const char *newline = bufferEnd > scanned
+            ? static_cast<const char *>(std::memchr(buffer.data() + scanned, '\n', bufferEnd - scanned))
+            : nullptr;
+        if (newline != nullptr)
+        {
+            size_t length = static_cast<size_t>(newline - (buffer.data() + bufferStart));
+            assignLine(line, buffer.data() + bufferStart, length);
+            bufferStart += length + 1;
+            return true;
+        }
+
+        scanned = bufferEnd - bufferStart;
+        if (eof || !fill())
+        {
+            // Última linha sem '\n'
+            if (bufferEnd > bufferStart)
+            {
+                assignLine(line, buffer.data() + bufferStart, bufferEnd - bufferStart);
+                bufferStart = bufferEnd;
+                return true;
+            }
+            return false;
+        }
+    }
+}
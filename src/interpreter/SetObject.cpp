@@ -0,0 +1,311 @@
+#include <interpreter/SetObject.hpp>
+#include <utils/Pool.hpp>
+#include <cmath>
+#include <stdexcept>
+
+// O índice cresce conforme precisa: reservar 'count' de uma vez fica mais
+// lento quando há repetidos, e não ganha nada quando não há
+SetObject::SetObject(const double *source, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        insertNumber(source[i], hashNumber(source[i]));
+    }
+}
+
+SetObject::SetObject(const std::vector<std::any> &source)
+{
+    for (const auto &value : source)
+    {
+        insert(value);
+    }
+}
+
+size_t SetObject::hashNumber(double number)
+{
+    if (std::isnan(number))
+    {
+        throw std::runtime_error("Set elements cannot be NaN");
+    }
+    return HashIndex::hashNumber(number);
+}
+
+size_t SetObject::hashElement(const std::any &value)
+{
+    size_t hash;
+    if (!HashIndex::hashKey(value, hash))
+    {
+        if (value.type() == typeid(double))
+        {
+            throw std::runtime_error("Set elements cannot be NaN");
+        }
+        throw std::runtime_error("Set elements must be strings, numbers or booleans");
+    }
+    return hash;
+}
+
+bool SetObject::isLive(size_t entry) const
+{
+    return numeric ? !std::isnan(numbers[entry]) : values[entry].has_value();
+}
+
+std::any SetObject::valueAt(size_t entry) const
+{
+    if (numeric)
+    {
+        return numbers[entry];
+    }
+    return values[entry];
+}
+
+size_t SetObject::findNumber(double number, size_t hash) const
+{
+    // Removidos são NaN e nunca batem
+    return index.find(hash, [&](uint32_t entry) { return numbers[entry] == number; });
+}
+
+size_t SetObject::find(const std::any &value, size_t hash) const
+{
+    if (numeric)
+    {
+        auto number = std::any_cast<double>(&value);
+        return number != nullptr ? findNumber(*number, hash) : HashIndex::npos;
+    }
+    return index.find(hash, [&](uint32_t entry) { return HashIndex::sameKey(values[entry], value); });
+}
+
+void SetObject::appendNumber(double number, size_t hash)
+{
+    if (index.full())
+    {
+        rebuild(1);
+    }
+    numbers.push_back(number);
+    live++;
+    index.insert(static_cast<uint32_t>(numbers.size() - 1), hash);
+}
+
+void SetObject::append(const std::any &value, size_t hash)
+{
+    if (index.full())
+    {
+        rebuild(1);
+    }
+    values.push_back(value);
+    live++;
+    index.insert(static_cast<uint32_t>(values.size() - 1), hash);
+}
+
+bool SetObject::insertNumber(double number, size_t hash)
+{
+    if (findNumber(number, hash) != HashIndex::npos)
+    {
+        return false;
+    }
+    appendNumber(number, hash);
+    return true;
+}
+
+bool SetObject::insert(const std::any &value)
+{
+    size_t hash = hashElement(value);
+    if (numeric)
+    {
+        if (auto number = std::any_cast<double>(&value))
+        {
+            return insertNumber(*number, hash);
+        }
+        demote();
+    }
+    if (find(value, hash) != HashIndex::npos)
+    {
+        return false;
+    }
+    append(value, hash);
+    return true;
+}
+
+void SetObject::demote()
+{
+    // As posições no índice continuam as mesmas: o hash de um número não
+    // muda por estar num std::any
+    values.reserve(numbers.size() + 1);
+    for (double number : numbers)
+    {
+        values.push_back(std::isnan(number) ? std::any() : std::any(number));
+    }
+    numbers.clear();
+    numbers.shrink_to_fit();
+    numeric = false;
+}
+
+void SetObject::rebuild(size_t extra)
+{
+    if (live != entryCount())
+    {
+        if (numeric)
+        {
+            std::erase_if(numbers, [](double number) { return std::isnan(number); });
+        }
+        else
+        {
+            std::erase_if(values, [](const std::any &value) { return !value.has_value(); });
+        }
+    }
+    index.reset(live + extra);
+    for (size_t entry = 0; entry < live; entry++)
+    {
+        size_t hash = numeric ? HashIndex::hashNumber(numbers[entry]) : hashElement(values[entry]);
+        index.insert(static_cast<uint32_t>(entry), hash);
+    }
+}
+
+void SetObject::copyFrom(const SetObject &other)
+{
+    numbers = other.numbers;
+    values = other.values;
+    numeric = other.numeric;
+    live = other.live;
+    index = other.index;
+}
+
+size_t SetObject::size() const
+{
+    auto lock = guard();
+    return live;
+}
+
+bool SetObject::add(const std::any &value)
+{
+    auto lock = guard();
+    return insert(value);
+}
+
+bool SetObject::has(const std::any &value) const
+{
+    size_t hash = hashElement(value);
+    auto lock = guard();
+    return find(value, hash) != HashIndex::npos;
+}
+
+bool SetObject::remove(const std::any &value)
+{
+    size_t hash = hashElement(value);
+    auto lock = guard();
+    size_t position = find(value, hash);
+    if (position == HashIndex::npos)
+    {
+        return false;
+    }
+
+    index.erase(position);
+    uint32_t entry = index.entry(position);
+    if (numeric)
+    {
+        numbers[entry] = std::nan("");
+    }
+    else
+    {
+        values[entry].reset();
+    }
+    live--;
+    // Muitos removidos: compacta antes que dominem o vetor
+    if (entryCount() > 2 * live + 8)
+    {
+        rebuild(0);
+    }
+    return true;
+}
+
+std::vector<std::any> SetObject::elements() const
+{
+    auto lock = guard();
+    std::vector<std::any> result;
+    result.reserve(live);
+    forEachLive([&](size_t entry) { result.push_back(valueAt(entry)); });
+    return result;
+}
+
+// Nas três operações o resultado é novo e só desta thread: não trava. left
+// e right são travados um de cada vez, então podem ser o mesmo conjunto.
+
+std::shared_ptr<SetObject> SetObject::unite(const SetObject &left, const SetObject &right)
+{
+    auto result = makePooled<SetObject>();
+    {
+        auto lock = left.guard();
+        result->copyFrom(left);
+    }
+
+    auto lock = right.guard();
+    if (result->numeric && right.numeric)
+    {
+        for (double number : right.numbers)
+        {
+            if (!std::isnan(number))
+            {
+                result->insertNumber(number, HashIndex::hashNumber(number));
+            }
+        }
+        return result;
+    }
+    right.forEachLive([&](size_t entry) { result->insert(right.valueAt(entry)); });
+    return result;
+}
+
+std::shared_ptr<SetObject> SetObject::filter(const SetObject &left, const SetObject &right, bool keep)
+{
+    // Copia os elementos de left antes de travar right
+    SetObject source;
+    {
+        auto lock = left.guard();
+        source.numbers = left.numbers;
+        source.values = left.values;
+        source.numeric = left.numeric;
+        source.live = left.live;
+    }
+
+    auto result = makePooled<SetObject>();
+    result->numeric = source.numeric;
+    auto lock = right.guard();
+    if (source.numeric)
+    {
+        for (double number : source.numbers)
+        {
+            if (std::isnan(number))
+            {
+                continue;
+            }
+            size_t hash = HashIndex::hashNumber(number);
+            size_t found = right.numeric ? right.findNumber(number, hash) : right.find(number, hash);
+            if ((found != HashIndex::npos) == keep)
+            {
+                result->appendNumber(number, hash);
+            }
+        }
+        return result;
+    }
+    for (const auto &value : source.values)
+    {
+        if (!value.has_value())
+        {
+            continue;
+        }
+        size_t hash = hashElement(value);
+        if ((right.find(value, hash) != HashIndex::npos) == keep)
+        {
+            result->append(value, hash);
+        }
+    }
+    return result;
+}
+
+std::shared_ptr<SetObject> SetObject::intersect(const SetObject &left, const SetObject &right)
+{
+    return filter(left, right, true);
+}
+
+std::shared_ptr<SetObject> SetObject::difference(const SetObject &left, const SetObject &right)
+{
+    return filter(left, right, false);
+}
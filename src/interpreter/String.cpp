@@ -0,0 +1,136 @@
+#include <interpreter/String.hpp>
+#include <utils/Pool.hpp>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <new>
+
+String::String(std::string_view text)
+{
+    if (text.size() <= inlineCapacity)
+    {
+        // Bytes não usados ficam zerados: handles inline iguais têm os
+        // mesmos bits
+        bits = inlineTag | (text.size() << 1);
+        std::memcpy(reinterpret_cast<char *>(&bits) + 1, text.data(), text.size());
+        return;
+    }
+    Block *created = allocate(text.size(), text.size());
+    std::memcpy(created->characters(), text.data(), text.size());
+    bits = reinterpret_cast<uintptr_t>(created);
+}
+
+String::Block *String::allocate(size_t size, size_t capacity)
+{
+    void *memory = Pool::allocate(sizeof(Block) + capacity);
+    Block *created = new (memory) Block;
+    created->references.store(1, std::memory_order_relaxed);
+    created->hash.store(0, std::memory_order_relaxed);
+    created->size = size;
+    created->capacity = capacity;
+    return created;
+}
+
+void String::release() noexcept
+{
+    if (!isInline() && block()->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        Block *dead = block();
+        size_t bytes = sizeof(Block) + dead->capacity;
+        dead->~Block();
+        Pool::deallocate(dead, bytes);
+    }
+}
+
+size_t String::hash() const noexcept
+{
+    if (isInline())
+    {
+        return std::hash<std::string_view>()(view());
+    }
+    size_t cached = block()->hash.load(std::memory_order_relaxed);
+    if (cached == 0)
+    {
+        // 0 marca "ainda não calculado"
+        cached = std::max<size_t>(std::hash<std::string_view>()(view()), 1);
+        block()->hash.store(cached, std::memory_order_relaxed);
+    }
+    return cached;
+}
+
+bool String::operator==(const String &other) const noexcept
+{
+    if (bits == other.bits)
+    {
+        return true;
+    }
+    // Strings curtas estão sempre no handle, então inline e bloco nunca
+    // são iguais, e dois inline só são iguais com os mesmos bits
+    if (isInline() || other.isInline())
+    {
+        return false;
+    }
+
+    Block *mine = block();
+    Block *theirs = other.block();
+    if (mine->size != theirs->size)
+    {
+        return false;
+    }
+    size_t myHash = mine->hash.load(std::memory_order_relaxed);
+    size_t theirHash = theirs->hash.load(std::memory_order_relaxed);
+    if (myHash != 0 && theirHash != 0 && myHash != theirHash)
+    {
+        return false;
+    }
+    return std::memcmp(mine->characters(), theirs->characters(), mine->size) == 0;
+}
+
+String String::concat(std::string_view left, std::string_view right)
+{
+    size_t size = left.size() + right.size();
+    if (size <= inlineCapacity)
+    {
+        char buffer[inlineCapacity];
+        std::memcpy(buffer, left.data(), left.size());
+        std::memcpy(buffer + left.size(), right.data(), right.size());
+        return String(std::string_view(buffer, size));
+    }
+
+    String result;
+    Block *created = allocate(size, size);
+    std::memcpy(created->characters(), left.data(), left.size());
+    std::memcpy(created->characters() + left.size(), right.data(), right.size());
+    result.bits = reinterpret_cast<uintptr_t>(created);
+    return result;
+}
+
+void String::append(std::string_view text)
+{
+    if (text.empty())
+    {
+        return;
+    }
+
+    size_t size = this->size() + text.size();
+    if (!isInline() && block()->references.load(std::memory_order_acquire) == 1 &&
+        size <= block()->capacity)
+    {
+        std::memcpy(block()->characters() + block()->size, text.data(), text.size());
+        block()->size = size;
+        block()->hash.store(0, std::memory_order_relaxed);
+        return;
+    }
+    if (size <= inlineCapacity)
+    {
+        *this = concat(view(), text);
+        return;
+    }
+
+    // Dobra a capacidade: uma sequência de appends custa tempo linear
+    Block *created = allocate(size, std::max(size, 2 * this->size()));
+    std::memcpy(created->characters(), data(), this->size());
+    std::memcpy(created->characters() + this->size(), text.data(), text.size());
+    release();
+    bits = reinterpret_cast<uintptr_t>(created);
+}
@@ -0,0 +1,50 @@
+#include <interpreter/StructObject.hpp>
+
+size_t Shape::slot(const std::string &field) const
+{
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+        if (fields[i] == field)
+        {
+            return i;
+        }
+    }
+    return npos;
+}
+
+std::any StructObject::get(size_t slot) const
+{
+    auto lock = guard();
+    return fields[slot];
+}
+
+void StructObject::set(size_t slot, std::any value)
+{
+    auto lock = guard();
+    fields[slot] = std::move(value);
+}
+
+std::vector<std::any> StructObject::values() const
+{
+    auto lock = guard();
+    return fields;
+}
+
+void StructObject::references(std::vector<Collectable *> &out) const
+{
+    for (const auto &field : fields)
+    {
+        if (Collectable *object = Collectable::of(field))
+        {
+            out.push_back(object);
+        }
+    }
+}
+
+void StructObject::clearReferences(std::vector<std::any> &dead)
+{
+    for (auto &field : fields)
+    {
+        dead.push_back(std::move(field));
+    }
+}
@@ -1,17 +1,119 @@
 #include <iostream>
+#include <string>
+#include <charconv>
+#include <cstring>
 #include <Monny.hpp>
+#include <runtime/Output.hpp>
+
+static int usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--max-depth N] [--gc-young N] [--gc-growth N] [--gc-stats] [--alloc-stats] [--flush line|size] [--load lib.so] [--batch dir|list] [--serve socket] file.mn.\n";
+    return EXIT_FAILURE;
+}
+
+// Inteiro sem sinal ocupando o argumento inteiro; false se não for
+static bool parseCount(const char *text, size_t &value)
+{
+    const char *end = text + std::strlen(text);
+    auto [stop, error] = std::from_chars(text, end, value);
+    return error == std::errc() && stop == end && stop != text;
+}
 
 int main(int argc, char **argv)
 {
+    std::string script;
+    std::string batch;
+    std::string socketPath;
+    std::string flush;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--max-depth" && i + 1 < argc)
+        {
+            if (!parseCount(argv[++i], Monny::options.maxDepth))
+            {
+                return usage(argv[0]);
+            }
+        }
+        else if (arg == "--gc-young" && i + 1 < argc)
+        {
+            if (!parseCount(argv[++i], Monny::options.heap.young))
+            {
+                return usage(argv[0]);
+            }
+        }
+        else if (arg == "--gc-growth" && i + 1 < argc)
+        {
+            if (!parseCount(argv[++i], Monny::options.heap.growth))
+            {
+                return usage(argv[0]);
+            }
+        }
+        else if (arg == "--gc-stats")
+        {
+            Monny::options.gcStats = true;
+        }
+        else if (arg == "--alloc-stats")
+        {
+            Monny::options.allocStats = true;
+        }
+        else if (arg == "--batch" && i + 1 < argc)
+        {
+            batch = argv[++i];
+        }
+        else if (arg == "--serve" && i + 1 < argc)
+        {
+            socketPath = argv[++i];
+        }
+        else if (arg == "--flush" && i + 1 < argc)
+        {
+            flush = argv[++i];
+            if (flush != "line" && flush != "size")
+            {
+                std::cerr << "--flush expects 'line' or 'size'.\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--load" && i + 1 < argc)
+        {
+            Monny::loadExtension(argv[++i]);
+        }
+        else if (script.empty())
+        {
+            script = arg;
+        }
+        else
+        {
+            return usage(argv[0]);
+        }
+    }
+
+    // Saída do processo num buffer grande; stdin sem sincronizar com stdio
+    std::ios::sync_with_stdio(false);
+    if (flush.empty())
+    {
+        OutputBuffer::installStandard();
+    }
+    else
+    {
+        OutputBuffer::installStandard(flush == "line" ? FlushPolicy::Line : FlushPolicy::Size);
+    }
+
+    if (!socketPath.empty())
+    {
+        return Monny::serve(socketPath);
+    }
 
-    if (argc > 2)
+    if (!batch.empty())
     {
-        std::cerr << "Usage: " << argv[0] << " file.mn.\n";
+        return Monny::runBatch(batch);
     }
 
-    if (argc == 2)
+    if (!script.empty())
     {
-        Monny::runScriptFile(argv[1]);
+        Monny::runScriptFile(script);
     }
     else
     {
@@ -19,4 +121,4 @@ int main(int argc, char **argv)
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
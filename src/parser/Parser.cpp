@@ -1,10 +1,12 @@
 #include <parser/Parser.hpp>
 #include <parser/Expr.hpp>
 #include <parser/Stmt.hpp>
+#include <interpreter/Builtins.hpp>
+#include <interpreter/String.hpp>
 #include <iostream>
 #include <stdexcept>
 
-Parser::Parser(const std::vector<Token> &tokens) : tokens(tokens) {}
+Parser::Parser(const std::vector<Token> &tokens) : tokens(tokens), sites(std::make_shared<SiteTable>()) {}
 
 std::vector<std::shared_ptr<Statements::Stmt>> Parser::parse()
 {
@@ -15,9 +17,28 @@ std::vector<std::shared_ptr<Statements::Stmt>> Parser::parse()
         statements.push_back(statement());
     }
 
+    resolveShadowedBuiltins();
     return statements;
 }
 
+void Parser::resolveShadowedBuiltins()
+{
+    for (const auto &call : builtinCalls)
+    {
+        auto var = std::static_pointer_cast<Variable>(call->callee);
+        if (userFunctions.count(var->name.lexeme))
+        {
+            call->builtin = -1;
+        }
+    }
+    // rebindsNothing aceitou to_string/len... que podem ter virado funções
+    for (const auto &assign : appendAssigns)
+    {
+        assign->appended.clear();
+        detectAppend(*assign);
+    }
+}
+
 std::vector<std::shared_ptr<Statements::Stmt>> Parser::block()
 {
     std::vector<std::shared_ptr<Statements::Stmt>> statements;
@@ -58,6 +79,10 @@ std::shared_ptr<Statements::Stmt> Parser::statement()
     {
         return forStatement();
     }
+    if (match(TokenType::PARALLEL))
+    {
+        return parallelForStatement();
+    }
     if (match(TokenType::LEFT_BRACE))
     {
         auto statements = block();
@@ -67,10 +92,21 @@ std::shared_ptr<Statements::Stmt> Parser::statement()
         return clearStatement();
     if (match(TokenType::FUNC))
         return functionStatement();
+    if (match(TokenType::ASYNC))
+    {
+        consume(TokenType::FUNC, "Expect 'func' after 'async'.");
+        auto function = functionStatement();
+        function->isAsync = true;
+        return function;
+    }
     if (match(TokenType::CONST))
     { // NOVO
         return constStatement();
     }
+    if (match(TokenType::STRUCT))
+    {
+        return structStatement();
+    }
     return expressionStatement();
 }
 
@@ -89,6 +125,7 @@ std::shared_ptr<Statements::Const> Parser::constStatement() {
 std::shared_ptr<Statements::FunctionDef> Parser::functionStatement()
 {
     Token name = consume(TokenType::IDENTIFIER, "Expected function name");
+    userFunctions.insert(name.lexeme);
 
     consume(TokenType::LEFT_PAREN, "Expected '(' after function name.");
 
@@ -110,6 +147,32 @@ std::shared_ptr<Statements::FunctionDef> Parser::functionStatement()
     return std::make_shared<Statements::FunctionDef>(name, params, body);
 }
 
+std::shared_ptr<Statements::StructDef> Parser::structStatement()
+{
+    Token name = consume(TokenType::IDENTIFIER, "Expected struct name");
+    // Point(1, 2) constrói: sombreia builtins como uma função
+    userFunctions.insert(name.lexeme);
+
+    consume(TokenType::LEFT_BRACE, "Expected '{' after struct name.");
+    std::vector<Token> fields;
+    std::unordered_set<std::string> seen;
+    if (!check(TokenType::RIGHT_BRACE))
+    {
+        do
+        {
+            Token field = consume(TokenType::IDENTIFIER, "Expect field name");
+            if (!seen.insert(field.lexeme).second)
+            {
+                throw std::runtime_error("Duplicate field '" + field.lexeme + "' in struct " + name.lexeme + ".");
+            }
+            fields.push_back(field);
+        } while (match(TokenType::COMMA));
+    }
+    consume(TokenType::RIGHT_BRACE, "Expected '}' after struct fields.");
+
+    return std::make_shared<Statements::StructDef>(name, std::move(fields));
+}
+
 std::shared_ptr<Statements::Clear> Parser::clearStatement()
 {
     consume(TokenType::LEFT_PAREN, "Expected '(' after clear");
@@ -233,6 +296,267 @@ std::shared_ptr<Statements::Stmt> Parser::forStatement()
     return whileLoop;
 }
 
+std::shared_ptr<Statements::ParallelFor> Parser::parallelForStatement()
+{
+    const std::string form = "parallel for expects 'def i = start; i < end; i++'.";
+    consume(TokenType::FOR, "Expect 'for' after 'parallel'.");
+    consume(TokenType::LEFT_PAREN, "Expect '(' after 'for'.");
+
+    // Só a forma canônica: o intervalo precisa ser conhecido antes de dividir
+    consume(TokenType::DEF, form);
+    Token variable = consume(TokenType::IDENTIFIER, form);
+    consume(TokenType::EQUAL, form);
+    std::shared_ptr<Expr> start = expression();
+    consume(TokenType::SEMICOLON, form);
+
+    if (consume(TokenType::IDENTIFIER, form).lexeme != variable.lexeme)
+    {
+        throw std::runtime_error(form);
+    }
+    bool inclusive = false;
+    if (match(TokenType::LESS_EQUAL))
+    {
+        inclusive = true;
+    }
+    else
+    {
+        consume(TokenType::LESS, form);
+    }
+    std::shared_ptr<Expr> end = expression();
+    consume(TokenType::SEMICOLON, form);
+
+    auto increment = std::dynamic_pointer_cast<Increment>(expression());
+    auto counter = increment ? std::dynamic_pointer_cast<Variable>(increment->operand) : nullptr;
+    if (counter == nullptr || increment->oper.type != TokenType::PLUS_PLUS ||
+        counter->name.lexeme != variable.lexeme)
+    {
+        throw std::runtime_error(form);
+    }
+    consume(TokenType::RIGHT_PAREN, "Expect ')' after for clauses.");
+
+    // reduce(+: soma, max: maior) - 'reduce' não é palavra reservada
+    std::vector<Statements::ParallelFor::Reduction> reductions;
+    std::unordered_set<std::string> reductionNames;
+    if (check(TokenType::IDENTIFIER) && peek().lexeme == "reduce")
+    {
+        advance();
+        consume(TokenType::LEFT_PAREN, "Expect '(' after 'reduce'.");
+        do
+        {
+            Token oper = advance();
+            bool known = oper.type == TokenType::PLUS || oper.type == TokenType::STAR ||
+                         (oper.type == TokenType::IDENTIFIER && (oper.lexeme == "min" || oper.lexeme == "max"));
+            if (!known)
+            {
+                throw std::runtime_error("Unknown reduction '" + oper.lexeme + "', expected +, *, min or max.");
+            }
+            consume(TokenType::COLON, "Expect ':' after reduction operator.");
+            Token name = consume(TokenType::IDENTIFIER, "Expect variable name in reduction.");
+            reductions.push_back({oper, name});
+            reductionNames.insert(name.lexeme);
+        } while (match(TokenType::COMMA));
+        consume(TokenType::RIGHT_PAREN, "Expect ')' after reductions.");
+    }
+
+    std::shared_ptr<Statements::Stmt> body = statement();
+    auto block = std::dynamic_pointer_cast<Statements::Block>(body);
+    if (block == nullptr)
+    {
+        block = std::make_shared<Statements::Block>(std::vector<std::shared_ptr<Statements::Stmt>>{body});
+    }
+
+    std::unordered_set<std::string> locals;
+    checkParallelBody(block, locals, reductionNames);
+
+    return std::make_shared<Statements::ParallelFor>(variable, start, end, inclusive,
+                                                     std::move(reductions), block);
+}
+
+// Rejeita escritas em variáveis compartilhadas no corpo de um parallel for.
+// 'locals' é o que está declarado no ponto atual; cada bloco interno
+// trabalha numa cópia, e o que ele declara some quando o bloco acaba.
+void Parser::checkParallelBody(const std::shared_ptr<Statements::Stmt> &stmt,
+                               std::unordered_set<std::string> &locals,
+                               const std::unordered_set<std::string> &reductions)
+{
+    if (stmt == nullptr)
+    {
+        return;
+    }
+    if (auto print = std::dynamic_pointer_cast<Statements::Print>(stmt))
+    {
+        for (const auto &expr : print->expressions)
+        {
+            checkParallelBody(expr, locals, reductions);
+        }
+    }
+    else if (auto exprStmt = std::dynamic_pointer_cast<Statements::Expression>(stmt))
+    {
+        checkParallelBody(exprStmt->expression, locals, reductions);
+    }
+    else if (auto var = std::dynamic_pointer_cast<Statements::Var>(stmt))
+    {
+        checkParallelBody(var->initializer, locals, reductions);
+        locals.insert(var->name.lexeme);
+    }
+    else if (auto constant = std::dynamic_pointer_cast<Statements::Const>(stmt))
+    {
+        checkParallelBody(constant->initializer, locals, reductions);
+        locals.insert(constant->name.lexeme);
+    }
+    else if (auto ifStmt = std::dynamic_pointer_cast<Statements::IF>(stmt))
+    {
+        checkParallelBody(ifStmt->condition, locals, reductions);
+        checkParallelBody(ifStmt->thenBranch, locals, reductions);
+        checkParallelBody(ifStmt->elseBranch, locals, reductions);
+    }
+    else if (auto block = std::dynamic_pointer_cast<Statements::Block>(stmt))
+    {
+        std::unordered_set<std::string> scope = locals;
+        for (const auto &inner : block->statements)
+        {
+            checkParallelBody(inner, scope, reductions);
+        }
+    }
+    else if (auto whileStmt = std::dynamic_pointer_cast<Statements::While>(stmt))
+    {
+        checkParallelBody(whileStmt->condition, locals, reductions);
+        checkParallelBody(whileStmt->body, locals, reductions);
+    }
+    else if (auto function = std::dynamic_pointer_cast<Statements::FunctionDef>(stmt))
+    {
+        // O corpo de uma função roda no próprio environment
+        locals.insert(function->name.lexeme);
+    }
+    else if (auto structDef = std::dynamic_pointer_cast<Statements::StructDef>(stmt))
+    {
+        locals.insert(structDef->name.lexeme);
+    }
+    else if (auto inner = std::dynamic_pointer_cast<Statements::ParallelFor>(stmt))
+    {
+        checkParallelBody(inner->start, locals, reductions);
+        checkParallelBody(inner->end, locals, reductions);
+    }
+}
+
+void Parser::checkParallelBody(const std::shared_ptr<Expr> &expr,
+                               std::unordered_set<std::string> &locals,
+                               const std::unordered_set<std::string> &reductions)
+{
+    if (expr == nullptr)
+    {
+        return;
+    }
+
+    auto checkWrite = [&](const Token &name)
+    {
+        if (!locals.count(name.lexeme) && !reductions.count(name.lexeme))
+        {
+            throw std::runtime_error("Cannot assign to shared variable '" + name.lexeme +
+                                     "' inside parallel for (declare it in the body or add it to reduce).");
+        }
+    };
+
+    if (auto assign = std::dynamic_pointer_cast<Assign>(expr))
+    {
+        checkParallelBody(assign->value, locals, reductions);
+        checkWrite(assign->name);
+    }
+    else if (auto increment = std::dynamic_pointer_cast<Increment>(expr))
+    {
+        if (auto var = std::dynamic_pointer_cast<Variable>(increment->operand))
+        {
+            checkWrite(var->name);
+        }
+    }
+    else if (std::dynamic_pointer_cast<Return>(expr))
+    {
+        throw std::runtime_error("Cannot return from inside parallel for.");
+    }
+    else if (auto binary = std::dynamic_pointer_cast<Binary>(expr))
+    {
+        checkParallelBody(binary->left, locals, reductions);
+        checkParallelBody(binary->right, locals, reductions);
+    }
+    else if (auto logical = std::dynamic_pointer_cast<Logical>(expr))
+    {
+        checkParallelBody(logical->left, locals, reductions);
+        checkParallelBody(logical->right, locals, reductions);
+    }
+    else if (auto grouping = std::dynamic_pointer_cast<Grouping>(expr))
+    {
+        checkParallelBody(grouping->expression, locals, reductions);
+    }
+    else if (auto unary = std::dynamic_pointer_cast<Unary>(expr))
+    {
+        checkParallelBody(unary->right, locals, reductions);
+    }
+    else if (auto call = std::dynamic_pointer_cast<FunctionCall>(expr))
+    {
+        for (const auto &arg : call->arguments)
+        {
+            checkParallelBody(arg, locals, reductions);
+        }
+    }
+    else if (auto spawn = std::dynamic_pointer_cast<Spawn>(expr))
+    {
+        checkParallelBody(spawn->call, locals, reductions);
+    }
+    else if (auto await = std::dynamic_pointer_cast<Await>(expr))
+    {
+        checkParallelBody(await->value, locals, reductions);
+    }
+    else if (auto literal = std::dynamic_pointer_cast<ArrayLiteral>(expr))
+    {
+        for (const auto &element : literal->elements)
+        {
+            checkParallelBody(element, locals, reductions);
+        }
+    }
+    else if (auto literal = std::dynamic_pointer_cast<MapLiteral>(expr))
+    {
+        for (size_t i = 0; i < literal->keys.size(); i++)
+        {
+            checkParallelBody(literal->keys[i], locals, reductions);
+            checkParallelBody(literal->values[i], locals, reductions);
+        }
+    }
+    else if (auto access = std::dynamic_pointer_cast<ArrayAccess>(expr))
+    {
+        checkParallelBody(access->array, locals, reductions);
+        checkParallelBody(access->index, locals, reductions);
+    }
+    else if (auto slice = std::dynamic_pointer_cast<ArraySlice>(expr))
+    {
+        checkParallelBody(slice->array, locals, reductions);
+        if (slice->start)
+        {
+            checkParallelBody(slice->start, locals, reductions);
+        }
+        if (slice->end)
+        {
+            checkParallelBody(slice->end, locals, reductions);
+        }
+    }
+    else if (auto arrayAssign = std::dynamic_pointer_cast<ArrayAssign>(expr))
+    {
+        // Arrays são seguros entre threads; cada iteração escreve onde quiser
+        checkParallelBody(arrayAssign->array, locals, reductions);
+        checkParallelBody(arrayAssign->index, locals, reductions);
+        checkParallelBody(arrayAssign->value, locals, reductions);
+    }
+    else if (auto getField = std::dynamic_pointer_cast<GetField>(expr))
+    {
+        checkParallelBody(getField->object, locals, reductions);
+    }
+    else if (auto setField = std::dynamic_pointer_cast<SetField>(expr))
+    {
+        // Instâncias travam como arrays
+        checkParallelBody(setField->object, locals, reductions);
+        checkParallelBody(setField->value, locals, reductions);
+    }
+}
+
 std::shared_ptr<Statements::IF> Parser::ifStatement()
 {
     consume(TokenType::LEFT_PAREN, "Expected '(' after if");
@@ -328,7 +652,13 @@ std::shared_ptr<Expr> Parser::assignment()
         if (auto var = std::dynamic_pointer_cast<Variable>(expr))
         {
             Token name = var->name;
-            return std::make_shared<Assign>(name, value);
+            auto assign = std::make_shared<Assign>(name, value);
+            detectAppend(*assign);
+            if (!assign->appended.empty())
+            {
+                appendAssigns.push_back(assign);
+            }
+            return assign;
         }
 
         if (auto arrayAccess = std::dynamic_pointer_cast<ArrayAccess>(expr))
@@ -336,12 +666,99 @@ std::shared_ptr<Expr> Parser::assignment()
             return std::make_shared<ArrayAssign>(arrayAccess->array, arrayAccess->index, value);
         }
 
+        if (auto getField = std::dynamic_pointer_cast<GetField>(expr))
+        {
+            return std::make_shared<SetField>(getField->object, getField->name, value, sites);
+        }
+
         throw std::runtime_error("Invalid assignment target.");
     }
 
     return expr;
 }
 
+void Parser::detectAppend(Assign &assign)
+{
+    // Desce pela esquerda de (((s + a) + b) + c) juntando os trechos
+    std::vector<std::shared_ptr<Expr>> pieces;
+    std::shared_ptr<Expr> current = assign.value;
+    while (auto binary = std::dynamic_pointer_cast<Binary>(current))
+    {
+        if (binary->oper.type != TokenType::PLUS || !rebindsNothing(binary->right))
+        {
+            return;
+        }
+        pieces.push_back(binary->right);
+        current = binary->left;
+    }
+
+    auto var = std::dynamic_pointer_cast<Variable>(current);
+    if (var != nullptr && var->name.lexeme == assign.name.lexeme && !pieces.empty())
+    {
+        assign.appended.assign(pieces.rbegin(), pieces.rend());
+    }
+}
+
+bool Parser::rebindsNothing(const std::shared_ptr<Expr> &expr)
+{
+    // Chamadas de função do usuário podem atribuir qualquer variável
+    // (escopo dinâmico), então só builtins que não chamam código Monny
+    if (std::dynamic_pointer_cast<Literal>(expr) || std::dynamic_pointer_cast<Variable>(expr))
+    {
+        return true;
+    }
+    if (auto binary = std::dynamic_pointer_cast<Binary>(expr))
+    {
+        return rebindsNothing(binary->left) && rebindsNothing(binary->right);
+    }
+    if (auto logical = std::dynamic_pointer_cast<Logical>(expr))
+    {
+        return rebindsNothing(logical->left) && rebindsNothing(logical->right);
+    }
+    if (auto grouping = std::dynamic_pointer_cast<Grouping>(expr))
+    {
+        return rebindsNothing(grouping->expression);
+    }
+    if (auto unary = std::dynamic_pointer_cast<Unary>(expr))
+    {
+        return rebindsNothing(unary->right);
+    }
+    if (auto access = std::dynamic_pointer_cast<ArrayAccess>(expr))
+    {
+        return rebindsNothing(access->array) && rebindsNothing(access->index);
+    }
+    if (auto slice = std::dynamic_pointer_cast<ArraySlice>(expr))
+    {
+        return rebindsNothing(slice->array) && (!slice->start || rebindsNothing(slice->start)) &&
+               (!slice->end || rebindsNothing(slice->end));
+    }
+    if (auto getField = std::dynamic_pointer_cast<GetField>(expr))
+    {
+        return rebindsNothing(getField->object);
+    }
+    if (auto call = std::dynamic_pointer_cast<FunctionCall>(expr))
+    {
+        if (call->builtin < 0)
+        {
+            return false;
+        }
+        const std::string &name = Builtins::get(call->builtin).name;
+        if (name != "to_string" && name != "to_number" && name != "len")
+        {
+            return false;
+        }
+        for (const auto &arg : call->arguments)
+        {
+            if (!rebindsNothing(arg))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
 std::shared_ptr<Expr> Parser::logicalOr()
 {
     std::shared_ptr<Expr> expr = logicalAnd();
@@ -447,6 +864,24 @@ std::shared_ptr<Expr> Parser::unary()
         return std::make_shared<Unary>(oper, right);
     }
 
+    if (match(TokenType::AWAIT))
+    {
+        Token keyword = previous();
+        return std::make_shared<Await>(keyword, unary());
+    }
+
+    if (match(TokenType::SPAWN))
+    {
+        Token keyword = previous();
+        auto target = std::dynamic_pointer_cast<FunctionCall>(call());
+        if (target == nullptr)
+        {
+            throw std::runtime_error("Expect user function call after 'spawn'.");
+        }
+        // Se o nome é de um builtin ou de uma função só se sabe ao executar
+        return std::make_shared<Spawn>(keyword, target);
+    }
+
     return call();
 }
 
@@ -464,6 +899,11 @@ std::shared_ptr<Expr> Parser::call()
         {
             expr = finishArrayAccess(expr);
         }
+        else if (match(TokenType::DOT))
+        {
+            Token name = consume(TokenType::IDENTIFIER, "Expect field name after '.'.");
+            expr = std::make_shared<GetField>(expr, name, sites);
+        }
         else
         {
             break;
@@ -490,14 +930,39 @@ std::shared_ptr<Expr> Parser::finishFunctionCall(std::shared_ptr<Expr> callee)
     }
 
     consume(TokenType::RIGHT_PAREN, "Expected ')' after arguments.");
-    return std::make_shared<FunctionCall>(callee, arguments);
+
+    auto call = std::make_shared<FunctionCall>(callee, arguments, sites);
+    if (auto var = std::dynamic_pointer_cast<Variable>(callee))
+    {
+        call->builtin = Builtins::lookup(var->name.lexeme);
+        if (call->builtin >= 0)
+        {
+            builtinCalls.push_back(call);
+        }
+    }
+    return call;
 }
 
 std::shared_ptr<Expr> Parser::finishArrayAccess(std::shared_ptr<Expr> array)
 {
-    std::shared_ptr<Expr> index = expression();
-    consume(TokenType::RIGHT_BRACKET, "Expect ']' after index.");
+    std::shared_ptr<Expr> index;
+    if (!check(TokenType::COLON))
+    {
+        index = expression();
+    }
 
+    if (match(TokenType::COLON))
+    {
+        std::shared_ptr<Expr> end;
+        if (!check(TokenType::RIGHT_BRACKET))
+        {
+            end = expression();
+        }
+        consume(TokenType::RIGHT_BRACKET, "Expect ']' after slice.");
+        return std::make_shared<ArraySlice>(array, index, end);
+    }
+
+    consume(TokenType::RIGHT_BRACKET, "Expect ']' after index.");
     return std::make_shared<ArrayAccess>(array, index);
 }
 
@@ -517,11 +982,40 @@ std::shared_ptr<Expr> Parser::arrayLiteral()
     return std::make_shared<ArrayLiteral>(elements);
 }
 
+std::shared_ptr<Expr> Parser::mapLiteral()
+{
+    std::vector<std::shared_ptr<Expr>> keys;
+    std::vector<std::shared_ptr<Expr>> values;
+
+    if (!check(TokenType::RIGHT_BRACE))
+    {
+        do
+        {
+            keys.push_back(expression());
+            consume(TokenType::COLON, "Expect ':' after map key.");
+            values.push_back(expression());
+        } while (match(TokenType::COMMA));
+    }
+
+    consume(TokenType::RIGHT_BRACE, "Expect '}' after map entries.");
+    return std::make_shared<MapLiteral>(keys, values);
+}
+
+// O texto do token vira String uma vez aqui, não a cada avaliação
+static std::any literalValue(const std::any &literal)
+{
+    if (auto text = std::any_cast<std::string>(&literal))
+    {
+        return String(*text);
+    }
+    return literal;
+}
+
 std::shared_ptr<Expr> Parser::basicPrimary()
 {
     if (match(TokenType::STRING) || match(TokenType::NUMBER))
     {
-        return std::make_shared<Literal>(previous().literal);
+        return std::make_shared<Literal>(literalValue(previous().literal));
     }
 
     if (match(TokenType::NIL)) {
@@ -549,6 +1043,13 @@ std::shared_ptr<Expr> Parser::basicPrimary()
         return arrayLiteral();
     }
 
+    // Em posição de expressão '{' só pode ser dicionário; no começo de um
+    // statement continua sendo bloco
+    if (match(TokenType::LEFT_BRACE))
+    {
+        return mapLiteral();
+    }
+
     if (match(TokenType::IDENTIFIER) || match(TokenType::TO_STRING) ||
         match(TokenType::INPUT) || match(TokenType::TO_NUMBER) || match(TokenType::CLEAR))
     {
@@ -577,7 +1078,7 @@ std::shared_ptr<Expr> Parser::basicPrimary()
             throw std::runtime_error("include() expects a string literal");
         }
 
-        std::shared_ptr<Expr> filename = std::make_shared<Literal>(peek().literal);
+        std::shared_ptr<Expr> filename = std::make_shared<Literal>(literalValue(peek().literal));
         advance(); // Consome a string
 
         consume(TokenType::RIGHT_PAREN, "Expect ')' after include filename");
@@ -585,7 +1086,9 @@ std::shared_ptr<Expr> Parser::basicPrimary()
         // Cria uma chamada de função include
         std::vector<std::shared_ptr<Expr>> args = {filename};
         auto includeVar = std::make_shared<Variable>(includeToken);
-        return std::make_shared<FunctionCall>(includeVar, args);
+        auto call = std::make_shared<FunctionCall>(includeVar, args, sites);
+        call->builtin = Builtins::lookup("include");
+        return call;
     }
 
     if (match(TokenType::RETURN))
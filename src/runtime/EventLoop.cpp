@@ -0,0 +1,424 @@
+#include <runtime/EventLoop.hpp>
+#include <runtime/ThreadPool.hpp>
+#include <interpreter/String.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+namespace
+{
+    // Pilha de cada fibra: só reservada, as páginas vêm sob demanda. Precisa
+    // cobrir a folga de 1 MB que o interpretador deixa para reportar estouro.
+    constexpr size_t fiberStackSize = 2 * 1024 * 1024;
+    // Pilhas guardadas para reuso em vez de munmap
+    constexpr size_t cachedStacks = 16;
+
+    thread_local std::unique_ptr<EventLoop> threadLoop;
+
+    Job sleepJob(EventLoop &loop, double milliseconds, std::shared_ptr<FutureObject> future)
+    {
+        int fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (fd < 0)
+        {
+            future->fail("sleep_async(): cannot create timer");
+            co_return;
+        }
+
+        // Zero desarmaria o timer
+        long long nanoseconds = milliseconds > 0 ? static_cast<long long>(milliseconds * 1e6) : 0;
+        nanoseconds = std::max(nanoseconds, 1LL);
+        itimerspec spec{};
+        spec.it_value.tv_sec = nanoseconds / 1000000000;
+        spec.it_value.tv_nsec = nanoseconds % 1000000000;
+        timerfd_settime(fd, 0, &spec, nullptr);
+
+        co_await loop.readable(fd);
+        close(fd);
+        future->complete(nullptr);
+    }
+
+    Job readFileJob(EventLoop &loop, std::string path, std::shared_ptr<FutureObject> future)
+    {
+        std::string content;
+        bool ok = false;
+
+        // Arquivo comum está sempre "pronto" para o epoll: a leitura em si
+        // vai para o pool e o loop segue atendendo as outras fibras
+        co_await loop.offload([&]()
+        {
+            int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return;
+            }
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                content.reserve(static_cast<size_t>(info.st_size));
+            }
+            char buffer[16384];
+            ssize_t count;
+            while ((count = read(fd, buffer, sizeof(buffer))) > 0)
+            {
+                content.append(buffer, static_cast<size_t>(count));
+            }
+            ok = count == 0;
+            close(fd);
+        });
+
+        if (ok)
+        {
+            future->complete(String(content));
+        }
+        else
+        {
+            future->fail("Cannot read file: " + path);
+        }
+    }
+
+    Job processJob(EventLoop &loop, std::string command, std::shared_ptr<FutureObject> future)
+    {
+        pid_t pid;
+        const char *argv[] = {"sh", "-c", command.c_str(), nullptr};
+        if (posix_spawn(&pid, "/bin/sh", nullptr, nullptr, const_cast<char *const *>(argv), environ) != 0)
+        {
+            future->fail("exec_async(): cannot start '" + command + "'");
+            co_return;
+        }
+
+        int status = 0;
+        int fd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+        if (fd >= 0)
+        {
+            // O pidfd fica legível quando o processo termina
+            co_await loop.readable(fd);
+            close(fd);
+            waitpid(pid, &status, 0);
+        }
+        else
+        {
+            // Kernel sem pidfd: espera bloqueando numa thread do pool
+            co_await loop.offload([&]() { waitpid(pid, &status, 0); });
+        }
+
+        double code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+        future->complete(code);
+    }
+}
+
+void FutureObject::complete(std::any result)
+{
+    value = std::move(result);
+    done = true;
+    for (Fiber *fiber : waiters)
+    {
+        owner->wake(fiber);
+    }
+    waiters.clear();
+}
+
+void FutureObject::fail(std::string message)
+{
+    error = std::move(message);
+    failed = true;
+    complete(nullptr);
+}
+
+EventLoop::EventLoop()
+    : epollFd(epoll_create1(EPOLL_CLOEXEC)), wakeFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+    if (epollFd < 0 || wakeFd < 0)
+    {
+        throw std::runtime_error("Cannot create event loop");
+    }
+    // data.ptr nulo marca o eventfd das conclusões do pool
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+}
+
+EventLoop::~EventLoop()
+{
+    close(epollFd);
+    close(wakeFd);
+    for (void *stack : freeStacks)
+    {
+        munmap(stack, fiberStackSize);
+    }
+}
+
+EventLoop &EventLoop::current()
+{
+    if (threadLoop == nullptr)
+    {
+        threadLoop = std::make_unique<EventLoop>();
+    }
+    return *threadLoop;
+}
+
+EventLoop *EventLoop::existing()
+{
+    return threadLoop.get();
+}
+
+std::shared_ptr<FutureObject> EventLoop::sleep(double milliseconds)
+{
+    auto future = std::make_shared<FutureObject>(this);
+    sleepJob(*this, milliseconds, future);
+    return future;
+}
+
+std::shared_ptr<FutureObject> EventLoop::readFile(const std::string &path)
+{
+    auto future = std::make_shared<FutureObject>(this);
+    readFileJob(*this, path, future);
+    return future;
+}
+
+std::shared_ptr<FutureObject> EventLoop::runProcess(const std::string &command)
+{
+    auto future = std::make_shared<FutureObject>(this);
+    processJob(*this, command, future);
+    return future;
+}
+
+void EventLoop::startFiber(std::function<void(uintptr_t stackBottom)> body)
+{
+    void *stack;
+    if (!freeStacks.empty())
+    {
+        stack = freeStacks.back();
+        freeStacks.pop_back();
+    }
+    else
+    {
+        stack = mmap(nullptr, fiberStackSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+        if (stack == MAP_FAILED)
+        {
+            throw std::runtime_error("Cannot allocate async function stack");
+        }
+        // Página de guarda no fundo
+        mprotect(stack, static_cast<size_t>(sysconf(_SC_PAGESIZE)), PROT_NONE);
+    }
+
+    auto *fiber = new Fiber;
+    fiber->stack = stack;
+    fiber->stackSize = fiberStackSize;
+    fiber->body = std::move(body);
+
+    getcontext(&fiber->context);
+    fiber->context.uc_stack.ss_sp = stack;
+    fiber->context.uc_stack.ss_size = fiberStackSize;
+    fiber->context.uc_link = nullptr;
+    makecontext(&fiber->context, fiberEntry, 0);
+
+    resume(fiber);
+}
+
+void EventLoop::fiberEntry()
+{
+    EventLoop &loop = current();
+    Fiber *fiber = loop.currentFiber;
+    uintptr_t bottom = reinterpret_cast<uintptr_t>(fiber->stack) + static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    try
+    {
+        fiber->body(bottom);
+    }
+    catch (...)
+    {
+        // O corpo já transforma erros em falha do future
+    }
+    fiber->finished = true;
+    fiber->body = nullptr;
+    swapcontext(&fiber->context, &fiber->caller);
+}
+
+void EventLoop::resume(Fiber *fiber)
+{
+    Fiber *previous = currentFiber;
+    currentFiber = fiber;
+    swapcontext(&fiber->caller, &fiber->context);
+    currentFiber = previous;
+
+    if (fiber->finished)
+    {
+        destroy(fiber);
+    }
+}
+
+void EventLoop::suspend()
+{
+    Fiber *fiber = currentFiber;
+    swapcontext(&fiber->context, &fiber->caller);
+}
+
+void EventLoop::destroy(Fiber *fiber)
+{
+    if (freeStacks.size() < cachedStacks)
+    {
+        freeStacks.push_back(fiber->stack);
+    }
+    else
+    {
+        munmap(fiber->stack, fiber->stackSize);
+    }
+    delete fiber;
+}
+
+void EventLoop::wake(Fiber *fiber)
+{
+    ready.push_back(fiber);
+}
+
+std::any EventLoop::await(const std::shared_ptr<FutureObject> &future)
+{
+    if (future->owner != this)
+    {
+        throw std::runtime_error("Future awaited on a different thread");
+    }
+
+    if (!future->done)
+    {
+        if (currentFiber != nullptr)
+        {
+            // Volta para quem retomou esta fibra; o complete a põe em 'ready'
+            future->waiters.push_back(currentFiber);
+            suspend();
+        }
+        else
+        {
+            while (!future->done)
+            {
+                if (!ready.empty())
+                {
+                    Fiber *fiber = ready.front();
+                    ready.pop_front();
+                    resume(fiber);
+                }
+                else if (pending == 0)
+                {
+                    throw std::runtime_error("await on a future that can never complete");
+                }
+                else
+                {
+                    poll();
+                }
+            }
+        }
+    }
+
+    if (future->failed)
+    {
+        throw std::runtime_error(future->error);
+    }
+    return future->value;
+}
+
+void EventLoop::drain()
+{
+    while (!ready.empty() || pending > 0)
+    {
+        if (!ready.empty())
+        {
+            Fiber *fiber = ready.front();
+            ready.pop_front();
+            resume(fiber);
+        }
+        else
+        {
+            poll();
+        }
+    }
+}
+
+void EventLoop::poll()
+{
+    epoll_event events[64];
+    int count = epoll_wait(epollFd, events, 64, -1);
+    if (count < 0)
+    {
+        if (errno == EINTR)
+        {
+            return;
+        }
+        throw std::runtime_error("epoll_wait failed");
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (events[i].data.ptr == nullptr)
+        {
+            uint64_t value;
+            while (read(wakeFd, &value, sizeof(value)) > 0)
+            {
+            }
+
+            std::vector<std::coroutine_handle<>> finished;
+            {
+                std::lock_guard<std::mutex> lock(completionMutex);
+                finished.swap(completions);
+            }
+            for (auto handle : finished)
+            {
+                pending--;
+                handle.resume();
+            }
+        }
+        else
+        {
+            pending--;
+            std::coroutine_handle<>::from_address(events[i].data.ptr).resume();
+        }
+    }
+}
+
+bool EventLoop::Readable::await_suspend(std::coroutine_handle<> handle)
+{
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.ptr = handle.address();
+    if (epoll_ctl(loop.epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        return false;
+    }
+    loop.pending++;
+    return true;
+}
+
+void EventLoop::Offload::await_suspend(std::coroutine_handle<> handle)
+{
+    loop.pending++;
+    EventLoop *owner = &loop;
+    ThreadPool::shared().submit([owner, handle, work = std::move(work)]()
+    {
+        try
+        {
+            work();
+        }
+        catch (...)
+        {
+            // Quem espera verifica o próprio resultado
+        }
+        {
+            std::lock_guard<std::mutex> lock(owner->completionMutex);
+            owner->completions.push_back(handle);
+        }
+        uint64_t one = 1;
+        (void)!write(owner->wakeFd, &one, sizeof(one));
+    });
+}
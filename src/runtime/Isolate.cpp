@@ -0,0 +1,47 @@
+#include <runtime/Isolate.hpp>
+#include <utils/HeapStack.hpp>
+
+Isolate::Isolate()
+{
+    inter.setStreams(input, output, errorStream);
+}
+
+bool Isolate::run(const Program &program)
+{
+    inter.setStackBottom(HeapStack::bottom());
+    try
+    {
+        ok = inter.run(program) && ok;
+    }
+    catch (const std::exception &error)
+    {
+        // Nada pode escapar para a thread do pool
+        errorStream << "Runtime error: " << error.what() << "\n";
+        ok = false;
+    }
+    return ok;
+}
+
+Isolate::Result Isolate::result() const
+{
+    return {ok, output.str(), errorStream.str()};
+}
+
+std::vector<Isolate::Result> Isolate::runAll(const std::vector<std::shared_ptr<const Program>> &programs,
+                                             ThreadPool &pool)
+{
+    std::vector<Isolate::Result> results(programs.size());
+
+    for (size_t i = 0; i < programs.size(); i++)
+    {
+        pool.submit([&programs, &results, i]()
+        {
+            Isolate isolate;
+            isolate.run(*programs[i]);
+            results[i] = isolate.result();
+        });
+    }
+
+    pool.wait();
+    return results;
+}
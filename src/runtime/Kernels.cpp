@@ -0,0 +1,419 @@
+#include <runtime/Kernels.hpp>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MONNY_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Reduções: 16 somas parciais (4 registradores de 4 doubles), elemento
+    // i na parcial i % 16, combinadas sempre na mesma ordem. A versão
+    // escalar reproduz exatamente as mesmas somas.
+    constexpr size_t lanes = 16;
+
+    double combine(const double partial[lanes])
+    {
+        // Registradores: (r0 + r1) + (r2 + r3); depois, entre as 4 posições
+        double lane[4];
+        for (size_t j = 0; j < 4; j++)
+        {
+            lane[j] = (partial[j] + partial[4 + j]) + (partial[8 + j] + partial[12 + j]);
+        }
+        return (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    }
+
+    double sumScalar(const double *values, size_t count)
+    {
+        double partial[lanes] = {};
+        size_t body = count - count % lanes;
+        for (size_t i = 0; i < body; i += lanes)
+        {
+            for (size_t j = 0; j < lanes; j++)
+            {
+                partial[j] += values[i + j];
+            }
+        }
+        double total = combine(partial);
+        for (size_t i = body; i < count; i++)
+        {
+            total += values[i];
+        }
+        return total;
+    }
+
+    double dotScalar(const double *left, const double *right, size_t count)
+    {
+        double partial[lanes] = {};
+        size_t body = count - count % lanes;
+        for (size_t i = 0; i < body; i += lanes)
+        {
+            for (size_t j = 0; j < lanes; j++)
+            {
+                partial[j] += left[i + j] * right[i + j];
+            }
+        }
+        double total = combine(partial);
+        for (size_t i = body; i < count; i++)
+        {
+            total += left[i] * right[i];
+        }
+        return total;
+    }
+
+    // value > best ? value : best, como o maxpd (NaN no valor é ignorado)
+    double maxScalar(const double *values, size_t count)
+    {
+        double best = values[0];
+        for (size_t i = 1; i < count; i++)
+        {
+            best = values[i] > best ? values[i] : best;
+        }
+        return best;
+    }
+
+    double minScalar(const double *values, size_t count)
+    {
+        double best = values[0];
+        for (size_t i = 1; i < count; i++)
+        {
+            best = values[i] < best ? values[i] : best;
+        }
+        return best;
+    }
+
+    bool holds(Kernels::Comparison comparison, double left, double right)
+    {
+        switch (comparison)
+        {
+            case Kernels::Comparison::Greater: return left > right;
+            case Kernels::Comparison::Less: return left < right;
+            default: return left == right;
+        }
+    }
+
+#ifdef MONNY_AVX2
+    bool hasAvx2()
+    {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+
+    __attribute__((target("avx2"))) double combine(__m256d r0, __m256d r1, __m256d r2, __m256d r3)
+    {
+        __m256d lane = _mm256_add_pd(_mm256_add_pd(r0, r1), _mm256_add_pd(r2, r3));
+        double values[4];
+        _mm256_storeu_pd(values, lane);
+        return (values[0] + values[1]) + (values[2] + values[3]);
+    }
+
+    __attribute__((target("avx2"))) double sumAvx2(const double *values, size_t count)
+    {
+        __m256d r0 = _mm256_setzero_pd(), r1 = r0, r2 = r0, r3 = r0;
+        size_t body = count - count % lanes;
+        for (size_t i = 0; i < body; i += lanes)
+        {
+            r0 = _mm256_add_pd(r0, _mm256_loadu_pd(values + i));
+            r1 = _mm256_add_pd(r1, _mm256_loadu_pd(values + i + 4));
+            r2 = _mm256_add_pd(r2, _mm256_loadu_pd(values + i + 8));
+            r3 = _mm256_add_pd(r3, _mm256_loadu_pd(values + i + 12));
+        }
+        double total = combine(r0, r1, r2, r3);
+        for (size_t i = body; i < count; i++)
+        {
+            total += values[i];
+        }
+        return total;
+    }
+
+    __attribute__((target("avx2"))) double dotAvx2(const double *left, const double *right, size_t count)
+    {
+        // mul + add separados (sem FMA), como na versão escalar
+        __m256d r0 = _mm256_setzero_pd(), r1 = r0, r2 = r0, r3 = r0;
+        size_t body = count - count % lanes;
+        for (size_t i = 0; i < body; i += lanes)
+        {
+            r0 = _mm256_add_pd(r0, _mm256_mul_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+            r1 = _mm256_add_pd(r1, _mm256_mul_pd(_mm256_loadu_pd(left + i + 4), _mm256_loadu_pd(right + i + 4)));
+            r2 = _mm256_add_pd(r2, _mm256_mul_pd(_mm256_loadu_pd(left + i + 8), _mm256_loadu_pd(right + i + 8)));
+            r3 = _mm256_add_pd(r3, _mm256_mul_pd(_mm256_loadu_pd(left + i + 12), _mm256_loadu_pd(right + i + 12)));
+        }
+        double total = combine(r0, r1, r2, r3);
+        for (size_t i = body; i < count; i++)
+        {
+            total += left[i] * right[i];
+        }
+        return total;
+    }
+
+    template <bool Greatest>
+    __attribute__((target("avx2"))) double extremeAvx2(const double *values, size_t count)
+    {
+        // Sem NaN, o resultado não depende da ordem; com NaN, cada posição
+        // segue a mesma regra da versão escalar
+        __m256d best = _mm256_set1_pd(values[0]);
+        size_t body = count - count % 4;
+        for (size_t i = 0; i < body; i += 4)
+        {
+            __m256d value = _mm256_loadu_pd(values + i);
+            best = Greatest ? _mm256_max_pd(value, best) : _mm256_min_pd(value, best);
+        }
+        double lane[4];
+        _mm256_storeu_pd(lane, best);
+        double result = lane[0];
+        for (size_t j = 1; j < 4; j++)
+        {
+            result = Greatest ? (lane[j] > result ? lane[j] : result) : (lane[j] < result ? lane[j] : result);
+        }
+        for (size_t i = body; i < count; i++)
+        {
+            result = Greatest ? (values[i] > result ? values[i] : result) : (values[i] < result ? values[i] : result);
+        }
+        return result;
+    }
+
+    __attribute__((target("avx2"))) void addAvx2(const double *left, const double *right, double *out, size_t count)
+    {
+        size_t body = count - count % 4;
+        for (size_t i = 0; i < body; i += 4)
+        {
+            _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+        }
+        for (size_t i = body; i < count; i++)
+        {
+            out[i] = left[i] + right[i];
+        }
+    }
+
+    __attribute__((target("avx2"))) void mulAvx2(const double *left, const double *right, double *out, size_t count)
+    {
+        size_t body = count - count % 4;
+        for (size_t i = 0; i < body; i += 4)
+        {
+            _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+        }
+        for (size_t i = body; i < count; i++)
+        {
+            out[i] = left[i] * right[i];
+        }
+    }
+
+    __attribute__((target("avx2"))) void addScalarAvx2(const double *values, double scalar, double *out, size_t count)
+    {
+        __m256d broadcast = _mm256_set1_pd(scalar);
+        size_t body = count - count % 4;
+        for (size_t i = 0; i < body; i += 4)
+        {
+            _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(values + i), broadcast));
+        }
+        for (size_t i = body; i < count; i++)
+        {
+            out[i] = values[i] + scalar;
+        }
+    }
+
+    __attribute__((target("avx2"))) void scaleAvx2(const double *values, double factor, double *out, size_t count)
+    {
+        __m256d broadcast = _mm256_set1_pd(factor);
+        size_t body = count - count % 4;
+        for (size_t i = 0; i < body; i += 4)
+        {
+            _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(values + i), broadcast));
+        }
+        for (size_t i = body; i < count; i++)
+        {
+            out[i] = values[i] * factor;
+        }
+    }
+
+    template <int Predicate>
+    __attribute__((target("avx2"))) void compareAvx2(const double *left, const double *right, size_t rightStep,
+                                                     double *out, size_t count)
+    {
+        // rightStep 0: compara com um escalar repetido
+        __m256d one = _mm256_set1_pd(1.0);
+        size_t body = count - count % 4;
+        for (size_t i = 0; i < body; i += 4)
+        {
+            __m256d other = rightStep == 0 ? _mm256_set1_pd(right[0]) : _mm256_loadu_pd(right + i);
+            __m256d mask = _mm256_cmp_pd(_mm256_loadu_pd(left + i), other, Predicate);
+            _mm256_storeu_pd(out + i, _mm256_and_pd(mask, one));
+        }
+        for (size_t i = body; i < count; i++)
+        {
+            double other = right[i * rightStep];
+            bool holds = Predicate == _CMP_GT_OQ ? left[i] > other
+                       : Predicate == _CMP_LT_OQ ? left[i] < other
+                                                 : left[i] == other;
+            out[i] = holds ? 1.0 : 0.0;
+        }
+    }
+
+    void compareAvx2(Kernels::Comparison comparison, const double *left, const double *right, size_t rightStep,
+                     double *out, size_t count)
+    {
+        switch (comparison)
+        {
+            case Kernels::Comparison::Greater: compareAvx2<_CMP_GT_OQ>(left, right, rightStep, out, count); break;
+            case Kernels::Comparison::Less: compareAvx2<_CMP_LT_OQ>(left, right, rightStep, out, count); break;
+            default: compareAvx2<_CMP_EQ_OQ>(left, right, rightStep, out, count); break;
+        }
+    }
+#else
+    constexpr bool hasAvx2()
+    {
+        return false;
+    }
+#endif
+}
+
+const char *Kernels::instructionSet()
+{
+    return hasAvx2() ? "avx2" : "scalar";
+}
+
+double Kernels::sum(const double *values, size_t count)
+{
+#ifdef MONNY_AVX2
+    if (hasAvx2())
+    {
+        return sumAvx2(values, count);
+    }
+#endif
+    return sumScalar(values, count);
+}
+
+double Kernels::min(const double *values, size_t count)
+{
+#ifdef MONNY_AVX2
+    if (hasAvx2())
+    {
+        return extremeAvx2<false>(values, count);
+    }
+#endif
+    return minScalar(values, count);
+}
+
+double Kernels::max(const double *values, size_t count)
+{
+#ifdef MONNY_AVX2
+    if (hasAvx2())
+    {
+        return extremeAvx2<true>(values, count);
+    }
+#endif
+    return maxScalar(values, count);
+}
+
+double Kernels::dot(const double *left, const double *right, size_t count)
+{
+#ifdef MONNY_AVX2
+    if (hasAvx2())
+    {
+        return dotAvx2(left, right, count);
+    }
+#endif
+    return dotScalar(left, right, count);
+}
+
+void Kernels::add(const double *left, const double *right, double *out, size_t count)
+{
+#ifdef MONNY_AVX2
+    if (hasAvx2())
+    {
+        addAvx2(left, right, out, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = left[i] + right[i];
+    }
+}
+
+void Kernels::addScalar(const double *values, double scalar, double *out, size_t count)
+{
+#ifdef MONNY_AVX2
+    if (hasAvx2())
+    {
+        addScalarAvx2(values, scalar, out, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = values[i] + scalar;
+    }
+}
+
+void Kernels::mul(const double *left, const double *right, double *out, size_t count)
+{
+#ifdef MONNY_AVX2
+    if (hasAvx2())
+    {
+        mulAvx2(left, right, out, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = left[i] * right[i];
+    }
+}
+
+void Kernels::scale(const double *values, double factor, double *out, size_t count)
+{
+#ifdef MONNY_AVX2
+    if (hasAvx2())
+    {
+        scaleAvx2(values, factor, out, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = values[i] * factor;
+    }
+}
+
+void Kernels::cumsum(const double *values, double *out, size_t count)
+{
+    // Cada soma depende da anterior: não há o que vetorizar sem mudar a
+    // ordem das somas (e o resultado)
+    double total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        total += values[i];
+        out[i] = total;
+    }
+}
+
+void Kernels::compare(Comparison comparison, const double *left, const double *right, double *out, size_t count)
+{
+#ifdef MONNY_AVX2
+    if (hasAvx2())
+    {
+        compareAvx2(comparison, left, right, 1, out, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = holds(comparison, left[i], right[i]) ? 1.0 : 0.0;
+    }
+}
+
+void Kernels::compareScalar(Comparison comparison, const double *values, double scalar, double *out, size_t count)
+{
+#ifdef MONNY_AVX2
+    if (hasAvx2())
+    {
+        compareAvx2(comparison, values, &scalar, 0, out, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = holds(comparison, values[i], scalar) ? 1.0 : 0.0;
+    }
+}
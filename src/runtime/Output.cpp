@@ -0,0 +1,195 @@
+#include <runtime/Output.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+OutputBuffer::OutputBuffer(int fd, FlushPolicy policy, bool ownsFd)
+    : fd(fd), ownsFd(ownsFd), policy(policy), buffer(new char[capacity])
+{
+}
+
+OutputBuffer::~OutputBuffer()
+{
+    flush();
+    if (replaced != nullptr)
+    {
+        // O std::cout ainda é usado depois, na destruição do próprio iostream
+        std::cout.rdbuf(replaced);
+    }
+    if (ownsFd)
+    {
+        ::close(fd);
+    }
+}
+
+std::unique_ptr<OutputBuffer> OutputBuffer::open(const std::string &path, bool append)
+{
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+    int fd = ::open(path.c_str(), flags, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot open file for writing: " + path);
+    }
+    return std::make_unique<OutputBuffer>(fd, FlushPolicy::Size, true);
+}
+
+void OutputBuffer::installStandard()
+{
+    installStandard(isatty(STDOUT_FILENO) ? FlushPolicy::Line : FlushPolicy::Size);
+}
+
+void OutputBuffer::installStandard(FlushPolicy policy)
+{
+    // Criado depois do iostream, então destruído antes dele
+    static OutputBuffer standard(STDOUT_FILENO, policy, false);
+
+    std::lock_guard<std::mutex> lock(standard.mutex);
+    standard.policy = policy;
+    if (standard.replaced == nullptr)
+    {
+        std::cout.flush();
+        standard.replaced = std::cout.rdbuf(&standard);
+    }
+}
+
+bool OutputBuffer::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return drain();
+}
+
+bool OutputBuffer::drain()
+{
+    size_t count = used;
+    used = 0;
+    return writeAll(buffer.get(), count);
+}
+
+bool OutputBuffer::writeAll(const char *data, size_t count)
+{
+    while (count > 0)
+    {
+        ssize_t written = ::write(fd, data, count);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        count -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+OutputBuffer::int_type OutputBuffer::overflow(int_type character)
+{
+    if (traits_type::eq_int_type(character, traits_type::eof()))
+    {
+        return traits_type::not_eof(character);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (used == capacity && !drain())
+    {
+        return traits_type::eof();
+    }
+    buffer[used++] = traits_type::to_char_type(character);
+    if (policy == FlushPolicy::Line && character == '\n' && !drain())
+    {
+        return traits_type::eof();
+    }
+    return character;
+}
+
+std::streamsize OutputBuffer::xsputn(const char *data, std::streamsize count)
+{
+    size_t size = static_cast<size_t>(count);
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (used + size > capacity && !drain())
+    {
+        return 0;
+    }
+    if (size >= capacity)
+    {
+        // Maior que o buffer: vai direto, sem cópia
+        return writeAll(data, size) ? count : 0;
+    }
+
+    std::memcpy(buffer.get() + used, data, size);
+    used += size;
+    if (policy == FlushPolicy::Line && std::memchr(data, '\n', size) != nullptr && !drain())
+    {
+        return 0;
+    }
+    return count;
+}
+
+int OutputBuffer::sync()
+{
+    return flush() ? 0 : -1;
+}
+
+void FileSinks::write(const std::string &path, const std::function<void(std::ostream &)> &writer)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &sink = open[path];
+    if (sink == nullptr)
+    {
+        try
+        {
+            sink = OutputBuffer::open(path, true);
+        }
+        catch (...)
+        {
+            open.erase(path);
+            throw;
+        }
+    }
+    std::ostream stream(sink.get());
+    writer(stream);
+}
+
+void FileSinks::forget(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    open.erase(path);
+}
+
+void FileSinks::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &[path, sink] : open)
+    {
+        if (!sink->flush())
+        {
+            throw std::runtime_error("Cannot write file: " + path);
+        }
+    }
+}
+
+void FileSinks::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string failed;
+    for (auto &[path, sink] : open)
+    {
+        if (!sink->flush() && failed.empty())
+        {
+            failed = path;
+        }
+    }
+    // Fecha todos mesmo se um falhou
+    open.clear();
+    if (!failed.empty())
+    {
+        throw std::runtime_error("Cannot write file: " + failed);
+    }
+}
@@ -0,0 +1,346 @@
+#include <runtime/Server.hpp>
+#include <interpreter/Inter.hpp>
+#include <utils/HeapStack.hpp>
+#include <Monny.hpp>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sysexits.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Streambuf que escreve direto no socket, em blocos de 4 KB
+    class SocketBuffer : public std::streambuf
+    {
+    public:
+        explicit SocketBuffer(int fd) : fd(fd)
+        {
+            setp(buffer, buffer + sizeof(buffer));
+        }
+
+        ~SocketBuffer() override
+        {
+            sync();
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (sync() != 0)
+            {
+                return traits_type::eof();
+            }
+            if (c != traits_type::eof())
+            {
+                *pptr() = static_cast<char>(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        int sync() override
+        {
+            const char *data = pbase();
+            size_t size = pptr() - pbase();
+            while (size > 0)
+            {
+                // MSG_NOSIGNAL: cliente que desconecta não derruba o servidor
+                ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+                if (sent <= 0)
+                {
+                    setp(buffer, buffer + sizeof(buffer));
+                    return -1;
+                }
+                data += sent;
+                size -= sent;
+            }
+            setp(buffer, buffer + sizeof(buffer));
+            return 0;
+        }
+
+    private:
+        int fd;
+        char buffer[4096];
+    };
+
+    // Leitura do pedido: linha de cabeçalho seguida (no EVAL) do código
+    class RequestReader
+    {
+    public:
+        explicit RequestReader(int fd) : fd(fd) {}
+
+        bool line(std::string &out)
+        {
+            size_t end;
+            while ((end = pending.find('\n')) == std::string::npos)
+            {
+                if (pending.size() > Server::maxHeaderBytes || !fill())
+                {
+                    return false;
+                }
+            }
+            out = pending.substr(0, end);
+            pending.erase(0, end + 1);
+            return true;
+        }
+
+        bool exact(size_t size, std::string &out)
+        {
+            while (pending.size() < size)
+            {
+                if (!fill())
+                {
+                    return false;
+                }
+            }
+            out = pending.substr(0, size);
+            pending.erase(0, size);
+            return true;
+        }
+
+        // A última leitura falhou por SO_RCVTIMEO
+        bool timedOut() const { return expired; }
+
+    private:
+        int fd;
+        std::string pending;
+        bool expired = false;
+
+        bool fill()
+        {
+            char chunk[4096];
+            ssize_t got = recv(fd, chunk, sizeof(chunk), 0);
+            if (got <= 0)
+            {
+                expired = got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+                return false;
+            }
+            pending.append(chunk, got);
+            return true;
+        }
+    };
+
+    // Tamanho do EVAL: só dígitos, até Server::maxEvalBytes
+    bool parseEvalSize(const std::string &text, size_t &size)
+    {
+        const char *end = text.data() + text.size();
+        auto [stop, error] = std::from_chars(text.data(), end, size);
+        return error == std::errc() && stop == end && stop != text.data() && size <= Server::maxEvalBytes;
+    }
+}
+
+Server::Server(const std::string &socketPath, size_t threads)
+    : socketPath(socketPath), pool(threads) {}
+
+Server::~Server()
+{
+    if (listener >= 0)
+    {
+        close(listener);
+        unlink(socketPath.c_str());
+    }
+}
+
+int Server::serve()
+{
+    std::signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "[ERROR]: socket path too long.\n";
+        return EX_USAGE;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+    if (listener < 0 ||
+        bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(listener, 128) != 0)
+    {
+        std::cerr << "[ERROR]: cannot listen on " << socketPath << ": " << std::strerror(errno) << "\n";
+        return EX_OSERR;
+    }
+
+    for (;;)
+    {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << "[ERROR]: accept failed: " << std::strerror(errno) << "\n";
+            return EX_OSERR;
+        }
+        pool.submit([this, client]() { handle(client); });
+    }
+}
+
+void Server::handle(int client)
+{
+    timeval timeout{receiveTimeoutSeconds, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    int status = EX_OK;
+    {
+        SocketBuffer buffer(client);
+        std::ostream out(&buffer);
+        RequestReader reader(client);
+
+        std::shared_ptr<const Program> program;
+        std::string header;
+        std::string source;
+
+        try
+        {
+            size_t size = 0;
+            if (!reader.line(header))
+            {
+                if (reader.timedOut())
+                {
+                    out << "[ERROR]: request timed out.\n";
+                }
+                status = EX_USAGE;
+            }
+            else if (header.rfind("RUN ", 0) == 0)
+            {
+                program = programForFile(header.substr(4));
+                if (program == nullptr)
+                {
+                    out << "[ERROR]: file not found.\n";
+                    status = EX_NOINPUT;
+                }
+            }
+            else if (header.rfind("EVAL ", 0) != 0)
+            {
+                out << "[ERROR]: expected 'RUN <path>' or 'EVAL <bytes>'.\n";
+                status = EX_USAGE;
+            }
+            else if (!parseEvalSize(header.substr(5), size))
+            {
+                out << "[ERROR]: EVAL expects a size of at most " << maxEvalBytes << " bytes.\n";
+                status = EX_USAGE;
+            }
+            else if (!reader.exact(size, source))
+            {
+                out << (reader.timedOut() ? "[ERROR]: request timed out.\n"
+                                          : "[ERROR]: connection closed before the EVAL code.\n");
+                status = EX_USAGE;
+            }
+            else
+            {
+                program = programForSource(source);
+            }
+        }
+        catch (const std::exception &error)
+        {
+            out << "Syntax error: " << error.what() << "\n";
+            status = EX_DATAERR;
+        }
+
+        if (program != nullptr)
+        {
+            // Um interpretador por worker, reaproveitado entre pedidos
+            thread_local Interpreter inter;
+            std::istringstream input;
+
+            inter.reset();
+            inter.setStreams(input, out, out);
+            inter.setStackBottom(HeapStack::bottom());
+            inter.setMaxDepth(Monny::options.maxDepth);
+            inter.setHeapLimits(Monny::options.heap);
+            try
+            {
+                status = inter.run(*program) ? EX_OK : EX_SOFTWARE;
+            }
+            catch (const std::exception &error)
+            {
+                out << "Runtime error: " << error.what() << "\n";
+                status = EX_SOFTWARE;
+            }
+            inter.setStreams(std::cin, std::cout, std::cerr);
+        }
+
+        out << '\0' << status << "\n";
+        out.flush();
+    }
+    close(client);
+}
+
+std::shared_ptr<const Program> Server::programForFile(const std::string &path)
+{
+    std::error_code error;
+    auto modified = fs::last_write_time(path, error);
+    if (error)
+    {
+        return nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto found = files.find(path);
+        if (found != files.end() && found->second.modified == modified)
+        {
+            return found->second.program;
+        }
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return nullptr;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    auto program = Monny::compile(contents.str());
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    files[path] = {modified, program};
+    return program;
+}
+
+std::shared_ptr<const Program> Server::programForSource(const std::string &source)
+{
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto found = sources.find(source);
+        if (found != sources.end())
+        {
+            return found->second;
+        }
+    }
+
+    auto program = Monny::compile(source);
+    // Código grande raramente se repete e prenderia a própria cópia no cache
+    if (source.size() > maxCachedSourceBytes)
+    {
+        return program;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    // Limite simples para o cache não crescer sem fim, em entradas e em bytes
+    if (sources.size() >= maxCachedSources ||
+        sourceBytes + source.size() > maxSourceCacheBytes)
+    {
+        sources.clear();
+        sourceBytes = 0;
+    }
+    if (sources.emplace(source, program).second)
+    {
+        sourceBytes += source.size();
+    }
+    return program;
+}
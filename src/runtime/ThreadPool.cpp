@@ -0,0 +1,197 @@
+#include <runtime/ThreadPool.hpp>
+
+// Worker da thread atual (se for de algum pool)
+static thread_local ThreadPool *currentPool = nullptr;
+static thread_local size_t currentIndex = 0;
+
+ThreadPool::ThreadPool(size_t count)
+{
+    if (count == 0)
+    {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        threads.emplace_back(&ThreadPool::work, this, i, nullptr);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    available.notify_all();
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    // compensate não cria mais extras depois de 'stopping'
+    for (auto &extra : extras)
+    {
+        extra.thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    // Conta antes de publicar, para 'queued' nunca ficar negativo
+    pending++;
+    queued++;
+
+    size_t target = currentPool == this ? currentIndex : nextQueue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+
+    // Trava também para não perder o wakeup de quem acabou de testar 'queued'
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        compensate();
+    }
+    available.notify_one();
+}
+
+void ThreadPool::beginBlocking()
+{
+    if (currentPool != this)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    blocked++;
+    compensate();
+}
+
+void ThreadPool::endBlocking()
+{
+    if (currentPool != this)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    blocked--;
+}
+
+void ThreadPool::compensate()
+{
+    // Chamado com sleepMutex travado
+    if (blocked == 0 || blocked < threads.size() + liveExtras || queued == 0 || stopping)
+    {
+        return;
+    }
+
+    // Extras que já saíram: o join só espera o fim da thread
+    for (auto it = extras.begin(); it != extras.end();)
+    {
+        if (it->done)
+        {
+            it->thread.join();
+            it = extras.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // O worker extra divide a fila de um dos originais
+    Extra &extra = extras.emplace_back();
+    liveExtras++;
+    extra.thread = std::thread(&ThreadPool::work, this, (threads.size() + liveExtras) % queues.size(), &extra);
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    idle.wait(lock, [this]() { return pending == 0; });
+}
+
+bool ThreadPool::runPending()
+{
+    return runOne(currentPool == this ? currentIndex : 0);
+}
+
+ThreadPool &ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+bool ThreadPool::runOne(size_t self)
+{
+    std::function<void()> task;
+
+    // Primeiro a própria fila, pelo fim
+    {
+        std::lock_guard<std::mutex> lock(queues[self]->mutex);
+        if (!queues[self]->tasks.empty())
+        {
+            task = std::move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+        }
+    }
+
+    // Depois rouba do começo das outras
+    for (size_t i = 1; !task && i < queues.size(); i++)
+    {
+        Queue &victim = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+
+    if (!task)
+    {
+        return false;
+    }
+
+    queued--;
+    task();
+
+    if (--pending == 0)
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        idle.notify_all();
+    }
+    return true;
+}
+
+void ThreadPool::work(size_t index, Extra *extra)
+{
+    currentPool = this;
+    currentIndex = index;
+
+    for (;;)
+    {
+        if (runOne(index))
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (extra != nullptr)
+        {
+            // Sem tarefa, o extra não é mais necessário; se os outros
+            // continuarem bloqueados, o próximo submit cria outro
+            extra->done = true;
+            liveExtras--;
+            return;
+        }
+        available.wait(lock, [this]() { return stopping || queued > 0; });
+        if (stopping && queued == 0)
+        {
+            return;
+        }
+    }
+}
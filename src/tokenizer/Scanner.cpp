@@ -133,6 +133,9 @@ void Scanner::scanToken()
     case '.':
         addToken(TokenType::DOT);
         break;
+    case ':':
+        addToken(TokenType::COLON);
+        break;
     case '-':
         if (match('-'))
         {
@@ -0,0 +1,101 @@
+#include <utils/HeapStack.hpp>
+
+#include <exception>
+#include <pthread.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace
+{
+    struct StackCall
+    {
+        const std::function<void()> *fn;
+        std::exception_ptr error;
+    };
+
+    void *stackEntry(void *arg)
+    {
+        auto *call = static_cast<StackCall *>(arg);
+        try
+        {
+            (*call->fn)();
+        }
+        catch (...)
+        {
+            call->error = std::current_exception();
+        }
+        return nullptr;
+    }
+}
+
+void HeapStack::run(size_t size, const std::function<void()> &fn)
+{
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size = (size + page - 1) / page * page;
+
+    // Página de guarda no fundo: estourar a pilha vira SIGSEGV imediato em vez
+    // de corromper memória vizinha
+    size_t total = size + page;
+    void *base = mmap(nullptr, total, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK,
+                      -1, 0);
+    if (base == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot allocate interpreter stack");
+    }
+    mprotect(base, page, PROT_NONE);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, static_cast<char *>(base) + page, size);
+
+    StackCall call{&fn, nullptr};
+    pthread_t thread;
+    int status = pthread_create(&thread, &attr, stackEntry, &call);
+    pthread_attr_destroy(&attr);
+
+    if (status == 0)
+    {
+        pthread_join(thread, nullptr);
+    }
+    munmap(base, total);
+
+    if (status != 0)
+    {
+        throw std::runtime_error("Cannot start interpreter thread");
+    }
+    if (call.error)
+    {
+        std::rethrow_exception(call.error);
+    }
+}
+
+uintptr_t HeapStack::bottom()
+{
+    // Vale para a thread principal, para threads de pool e para as pilhas de run
+    pthread_attr_t attr;
+    void *address = nullptr;
+    size_t size = 0;
+    if (pthread_getattr_np(pthread_self(), &attr) == 0)
+    {
+        pthread_attr_getstack(&attr, &address, &size);
+        pthread_attr_destroy(&attr);
+    }
+    if (address != nullptr)
+    {
+        return reinterpret_cast<uintptr_t>(address);
+    }
+
+    // Sem informação da thread: estima a partir do limite do processo
+    char marker;
+    uintptr_t here = reinterpret_cast<uintptr_t>(&marker);
+    struct rlimit limit;
+    size_t bytes = 8 * 1024 * 1024;
+    if (getrlimit(RLIMIT_STACK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+    {
+        bytes = static_cast<size_t>(limit.rlim_cur);
+    }
+    return bytes < here ? here - bytes : 0;
+}
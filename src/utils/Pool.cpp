@@ -0,0 +1,305 @@
+#include <utils/Pool.hpp>
+#include <array>
+#include <atomic>
+#include <mutex>
+
+namespace
+{
+    // Blocos múltiplos de 16 (o alinhamento do malloc): passos de 16 até
+    // 128, de 32 até 256 e de 64 até 512
+    constexpr std::array<size_t, 16> classSizes = {
+        16, 32, 48, 64, 80, 96, 112, 128,
+        160, 192, 224, 256,
+        320, 384, 448, 512};
+    constexpr size_t classCount = classSizes.size();
+
+    // Classe de cada tamanho, em unidades de 16 bytes
+    constexpr std::array<uint8_t, Pool::maxSize / 16 + 1> classIndex = []()
+    {
+        std::array<uint8_t, Pool::maxSize / 16 + 1> index{};
+        size_t current = 0;
+        for (size_t units = 0; units < index.size(); units++)
+        {
+            while (classSizes[current] < units * 16)
+            {
+                current++;
+            }
+            index[units] = static_cast<uint8_t>(current);
+        }
+        return index;
+    }();
+
+    size_t classOf(size_t size)
+    {
+        return classIndex[(size + 15) / 16];
+    }
+
+    // Um bloco livre guarda o próximo da lista nos próprios bytes
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    // Blocos trocados de uma vez entre uma thread e a lista global
+    constexpr size_t batchBytes = 8 * 1024;
+    // Acima disso a lista da thread devolve um lote para a global
+    constexpr size_t cacheBytes = 4 * batchBytes;
+
+    size_t batchOf(size_t index)
+    {
+        return batchBytes / classSizes[index];
+    }
+
+    struct ThreadCache;
+
+    // Estado global, nunca destruído: threads que terminam depois dos
+    // estáticos ainda devolvem blocos aqui
+    struct Shared
+    {
+        struct Class
+        {
+            std::mutex mutex;
+            FreeBlock *free = nullptr;
+            // Muda sob o lock; lido sem ele para não travar à toa
+            std::atomic<size_t> freeCount{0};
+            std::atomic<size_t> reserved{0};
+        };
+        std::array<Class, classCount> classes;
+
+        // Threads vivas, para somar as contagens
+        std::mutex registryMutex;
+        std::vector<ThreadCache *> caches;
+        // Contagens de threads que já terminaram, e das que estão terminando
+        // (depois do destrutor da cache)
+        std::array<std::atomic<size_t>, classCount> retiredAllocations{};
+        std::array<std::atomic<size_t>, classCount> retiredFrees{};
+    };
+
+    Shared &shared()
+    {
+        static Shared *instance = new Shared;
+        return *instance;
+    }
+
+    // Páginas novas são cortadas sob demanda por quem as pediu
+    struct ThreadCache
+    {
+        struct Class
+        {
+            FreeBlock *free = nullptr;
+            size_t freeCount = 0;
+            char *bump = nullptr;
+            char *end = nullptr;
+            // Só esta thread escreve; stats() lê de outras
+            std::atomic<size_t> allocations{0};
+            std::atomic<size_t> frees{0};
+        };
+        std::array<Class, classCount> classes;
+
+        ThreadCache();
+        ~ThreadCache();
+
+        void *refill(size_t index);
+        void spill(size_t index, size_t count);
+    };
+
+    // Depois do destrutor da cache, a thread libera direto na global
+    thread_local bool cacheGone = false;
+    thread_local ThreadCache cache;
+
+    void count(std::atomic<size_t> &counter)
+    {
+        // Um escritor só: sem instrução atômica
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    ThreadCache::ThreadCache()
+    {
+        Shared &global = shared();
+        std::lock_guard<std::mutex> lock(global.registryMutex);
+        global.caches.push_back(this);
+    }
+
+    ThreadCache::~ThreadCache()
+    {
+        Shared &global = shared();
+        for (size_t index = 0; index < classCount; index++)
+        {
+            Class &mine = classes[index];
+            // O resto da página entra na lista, para não ficar perdido
+            while (mine.bump != nullptr && mine.bump + classSizes[index] <= mine.end)
+            {
+                auto block = reinterpret_cast<FreeBlock *>(mine.bump);
+                mine.bump += classSizes[index];
+                block->next = mine.free;
+                mine.free = block;
+                mine.freeCount++;
+            }
+            spill(index, mine.freeCount);
+        }
+
+        std::lock_guard<std::mutex> lock(global.registryMutex);
+        for (size_t index = 0; index < classCount; index++)
+        {
+            global.retiredAllocations[index].fetch_add(classes[index].allocations.load(std::memory_order_relaxed),
+                                                       std::memory_order_relaxed);
+            global.retiredFrees[index].fetch_add(classes[index].frees.load(std::memory_order_relaxed),
+                                                 std::memory_order_relaxed);
+        }
+        std::erase(global.caches, this);
+        cacheGone = true;
+    }
+
+    void *ThreadCache::refill(size_t index)
+    {
+        Class &mine = classes[index];
+        size_t size = classSizes[index];
+
+        // Primeiro o resto da página atual: não trava nada. Blocos
+        // devolvidos por outras threads esperam a página acabar.
+        if (mine.bump == nullptr || mine.bump + size > mine.end)
+        {
+            Shared::Class &global = shared().classes[index];
+            if (global.freeCount.load(std::memory_order_relaxed) != 0)
+            {
+                std::lock_guard<std::mutex> lock(global.mutex);
+                size_t wanted = batchOf(index);
+                while (global.free != nullptr && wanted > 0)
+                {
+                    FreeBlock *block = global.free;
+                    global.free = block->next;
+                    global.freeCount.fetch_sub(1, std::memory_order_relaxed);
+                    block->next = mine.free;
+                    mine.free = block;
+                    mine.freeCount++;
+                    wanted--;
+                }
+            }
+            if (mine.free != nullptr)
+            {
+                FreeBlock *block = mine.free;
+                mine.free = block->next;
+                mine.freeCount--;
+                return block;
+            }
+
+            mine.bump = static_cast<char *>(::operator new(Pool::slabSize));
+            mine.end = mine.bump + Pool::slabSize;
+            global.reserved.fetch_add(Pool::slabSize, std::memory_order_relaxed);
+        }
+        void *block = mine.bump;
+        mine.bump += size;
+        return block;
+    }
+
+    void ThreadCache::spill(size_t index, size_t count)
+    {
+        Class &mine = classes[index];
+        if (count == 0)
+        {
+            return;
+        }
+        // Separa os 'count' primeiros e liga no começo da global
+        FreeBlock *first = mine.free;
+        FreeBlock *last = first;
+        for (size_t i = 1; i < count; i++)
+        {
+            last = last->next;
+        }
+        mine.free = last->next;
+        mine.freeCount -= count;
+
+        Shared::Class &global = shared().classes[index];
+        std::lock_guard<std::mutex> lock(global.mutex);
+        last->next = global.free;
+        global.free = first;
+        global.freeCount.fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+void *Pool::allocate(size_t size)
+{
+    if (size > maxSize)
+    {
+        return ::operator new(size);
+    }
+    if (cacheGone)
+    {
+        // Thread terminando: bloco avulso do tamanho da classe, que pode
+        // acabar na lista global quando for liberado
+        size_t index = classOf(size);
+        shared().retiredAllocations[index].fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(classSizes[index]);
+    }
+
+    size_t index = classOf(size);
+    ThreadCache::Class &mine = cache.classes[index];
+    count(mine.allocations);
+    if (FreeBlock *block = mine.free)
+    {
+        mine.free = block->next;
+        mine.freeCount--;
+        return block;
+    }
+    return cache.refill(index);
+}
+
+void Pool::deallocate(void *block, size_t size) noexcept
+{
+    if (block == nullptr)
+    {
+        return;
+    }
+    if (size > maxSize)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    size_t index = classOf(size);
+    auto freed = static_cast<FreeBlock *>(block);
+    if (cacheGone)
+    {
+        // Thread terminando: direto na lista global
+        Shared &state = shared();
+        state.retiredFrees[index].fetch_add(1, std::memory_order_relaxed);
+        Shared::Class &global = state.classes[index];
+        std::lock_guard<std::mutex> lock(global.mutex);
+        freed->next = global.free;
+        global.free = freed;
+        global.freeCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ThreadCache::Class &mine = cache.classes[index];
+    count(mine.frees);
+    freed->next = mine.free;
+    mine.free = freed;
+    mine.freeCount++;
+    if (mine.freeCount * classSizes[index] > cacheBytes)
+    {
+        cache.spill(index, batchOf(index));
+    }
+}
+
+std::vector<Pool::ClassStats> Pool::stats()
+{
+    Shared &global = shared();
+    std::vector<ClassStats> result(classCount);
+
+    std::lock_guard<std::mutex> lock(global.registryMutex);
+    for (size_t index = 0; index < classCount; index++)
+    {
+        ClassStats &entry = result[index];
+        entry.size = classSizes[index];
+        entry.allocations = global.retiredAllocations[index].load(std::memory_order_relaxed);
+        entry.frees = global.retiredFrees[index].load(std::memory_order_relaxed);
+        entry.reserved = global.classes[index].reserved.load(std::memory_order_relaxed);
+        for (ThreadCache *thread : global.caches)
+        {
+            entry.allocations += thread->classes[index].allocations.load(std::memory_order_relaxed);
+            entry.frees += thread->classes[index].frees.load(std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
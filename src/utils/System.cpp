@@ -3,6 +3,8 @@
 #include <iostream>
 
 void System::clear() {
+  // O clear escreve no mesmo terminal: o que está no buffer vem antes
+  std::cout.flush();
 #ifdef WIN32
   system("cls");
 #else
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Roda cada tests/*.mn e compara a saída (stdout e stderr) e o status de
+# saída com tests/<nome>.out. Opções de linha de comando do script vão numa
+# primeira linha "// flags: ...".
+#   tests/run.sh [caminho/do/monny]
+monny=$(realpath "${1:-build/linux/x86_64/release/monny}")
+cd "$(dirname "$0")" || exit 1
+
+failed=0
+for script in *.mn; do
+    name=${script%.mn}
+    flags=$(sed -n '1s|^// flags: ||p' "$script")
+    actual=$("$monny" $flags "$script" 2>&1; echo "[exit $?]")
+    if [ "$actual" = "$(cat "$name.out")" ]; then
+        echo "ok    $name"
+    else
+        echo "FAIL  $name"
+        echo "$actual" | diff "$name.out" - | sed 's/^/      /'
+        failed=$((failed + 1))
+    fi
+done
+
+[ "$failed" -eq 0 ]
@@ -1,13 +1,24 @@
 add_rules("mode.debug", "mode.release", "mode.check")
+set_languages("c++20")
+set_optimize("fastest")
+
+if is_mode("debug") then
+    add_cxflags("-fsanitize=address")
+    add_mxflags("-fsanitise=address")
+    add_ldflags("-fsanitize=address")
+end
+
+-- Biblioteca embutível: estática por padrão, compartilhada com `xmake f -k shared`
+target("libmonny")
+    set_kind("$(kind)")
+    set_basename("monny")
+    add_files("src/**.cpp|main.cpp")
+    add_includedirs("./include", {public = true})
+    add_syslinks("pthread", "dl", {public = true})
 
 target("monny")
     set_kind("binary")
-    add_files("src/**.cpp")
-    set_optimize("fastest")
-    add_includedirs("./include")
-    if is_mode("debug") then
-        add_cxflags("-fsanitize=address")
-        add_mxflags("-fsanitise=address")
-        add_ldflags("-fsanitize=address")
-    end
-
+    add_deps("libmonny")
+    add_files("src/main.cpp")
+    -- Extensões carregadas com --load chamam Builtins::add do executável
+    add_ldflags("-rdynamic")